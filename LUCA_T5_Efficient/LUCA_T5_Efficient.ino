@@ -9,7 +9,20 @@
 #include <ArduinoJson.h>
 #include "epd_driver.h"
 #include <Wire.h>
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+#include <esp_now.h>
 #include <esp_sleep.h>
+#include <esp_wifi.h>
+#include <driver/gpio.h>
+#include <driver/rtc_io.h>
+#include <luca_cadence.h>
+#include <luca_epd_diff.h>
+#include <luca_espnow.h>
+#include <luca_layout.h>
+#include <luca_status.h>
+#include <luca_status_frame.h>
+#include <luca_tls.h>
 
 // ==================== KONFIGURATION ====================
 #define LUCA_VERSION "alpha-369.1"
@@ -17,54 +30,192 @@
 #define WIFI_SSID "dein-wifi"
 #define WIFI_PASS "dein-pass"
 #define LUCA_SERVER "http://192.168.1.100:3690"
+// Für https://: pin-sha256 (base64) des Server-Schlüssels, siehe luca_core/luca_tls.h.
+// Ersetzt die Prüfung der Zertifikatskette; ohne gültigen Pin kein HTTPS.
+#define LUCA_SERVER_PIN ""
+
+// Abmessungen und Layout (Zonen, Tastatur) stehen in luca_core/luca_layout.h
+#define EPD_WIDTH LUCA_T5_WIDTH
+#define EPD_HEIGHT LUCA_T5_HEIGHT
+
+// Framebuffer des Treibers: 1 Bit/Pixel, zeilenweise, MSB zuerst
+#define EPD_ROW_BYTES ((EPD_WIDTH + 7) / 8)
+#define EPD_FB_BYTES (EPD_ROW_BYTES * EPD_HEIGHT)  // 3904 Bytes
+
+// Diff-Update: Vollbild-Refresh gegen Ghosting nach so vielen partiellen
+#define EPD_FULL_REFRESH_EVERY 36
+
+// Power-Save: Status alle 3.69s, adaptiv gestreckt (siehe ADAPTIVE KADENZ)
+#define STATUS_INTERVAL_MS 3690   // Basis-Intervall, Wake per Timer oder Touch
+#define STATUS_MAX_MS 900000      // Backoff-Obergrenze: 15 Minuten
+#define IDLE_SLEEP_MS 10000       // Inaktivität bis zum Deep-Sleep
+
+// Touch-Controller (GT911, I2C 0x5D): INT ist low-aktiv. Muss ein RTC-GPIO
+// sein, damit dieselbe Leitung auch aus dem Deep-Sleep weckt.
+#define TOUCH_INT_PIN GPIO_NUM_3
+#define TOUCH_SDA 18
+#define TOUCH_SCL 19
+#define GT911_ADDR 0x5D
+#define GT911_STATUS 0x814E       // Bit 7 = Report bereit, Bits 0-3 = Anzahl Punkte; Punkt 1 ab 0x814F
+
+// Fuel-Gauge (BQ27220) am selben I2C-Bus, liefert die Zellspannung
+#define BATTERY_GAUGE_ADDR 0x55
+#define BATTERY_GAUGE_VOLTAGE 0x08  // Voltage(), mV, little-endian
+
+// WiFi: gerichteter Join mit Cache, sonst voller Scan
+#define WIFI_FAST_TIMEOUT_MS 1500
+#define WIFI_FULL_TIMEOUT_MS 8000
+#define ESPNOW_REPLY_TIMEOUT_MS 20  // Gateway antwortet in ~1-2 ms
 
-#define EPD_WIDTH 250
-#define EPD_HEIGHT 122
+// ==================== EFFIZIENTE DISPLAY-STRUKTUR ====================
+typedef LucaZone DisplayArea;  // x, y, width, height
 
-// Power-Save: Wake every 3.69s oder bei Touch
-#define WAKE_INTERVAL_US 3690000  // 3.69 Sekunden
+// Geänderter Bereich für das Diff-Update (siehe epd_flush())
+typedef LucaDirtyBox DirtyBox;  // inklusiv, x0 > x1 = leer
 
-// ==================== EFFIZIENTE DISPLAY-STRUKTUR ====================
-struct DisplayArea {
-  int x, y, width, height;
-  bool needs_update = false;
-};
+// Teile Display in 9 Zonen (3x3 Grid für 3-6-9), zur Compile-Zeit berechnet
+const DisplayArea* const update_zones = LUCA_T5_ZONES.cells;
 
-// Teile Display in 9 Zonen (3x3 Grid für 3-6-9)
-DisplayArea update_zones[9] = {
-  {0, 0, 83, 40}, {83, 0, 84, 40}, {167, 0, 83, 40},
-  {0, 40, 83, 42}, {83, 40, 84, 42}, {167, 40, 83, 42},
-  {0, 82, 83, 40}, {83, 82, 84, 40}, {167, 82, 83, 40}
-};
+// Zonen, in die seit dem letzten epd_flush() gezeichnet wurde (Bit = Zone)
+uint16_t dirty_zones = 0;
 
 // ==================== EFFIZIENTE TASTATUR ====================
-#define KEYBOARD_ROWS 3
-#define KEYBOARD_COLS 9
-#define KEY_WIDTH (EPD_WIDTH / KEYBOARD_COLS)
-#define KEY_HEIGHT 8
+#define KEYBOARD_ROWS LUCA_T5_KEY_ROWS
+#define KEYBOARD_COLS LUCA_T5_KEY_COLS
+#define KEY_SEND '>'
 
 // Optimales Layout: QWERTZ + Zahlen in 3-6-9-Anordnung
 const char keyboard[KEYBOARD_ROWS][KEYBOARD_COLS] = {
   {'1','2','3','4','5','6','7','8','9'},
   {'Q','W','E','R','T','Z','U','I','O'},
-  {'A','S','D','F','G','H','J','K','↵'}  // ↵ = Senden
+  {'A','S','D','F','G','H','J','K',KEY_SEND}
 };
 
+// POD ohne Member-Initialisierer, damit die Struktur auch im RTC-Memory
+// (WarmState) liegen kann, ohne dass ein Konstruktor sie beim Boot überschreibt
 struct KeyboardState {
   char buffer[64];
-  int cursor = 0;
-  int selected_row = 0;
-  int selected_col = 0;
-  bool shift_mode = false;
-  unsigned long last_key_time = 0;  // Debounce
-} kb;
-
-// ==================== LUCA-STATUS (minimal) ====================
-struct LucaStatus {
-  float consciousness = 0;
-  int resonance = 6;  // Resonanz 6 = Polarlicht-Orange, Transformation, 6. Sinn
-  bool life_active = false;
-} luca;
+  int cursor;
+  int selected_row;
+  int selected_col;
+  bool shift_mode;
+  unsigned long last_key_time;  // Debounce
+};
+
+KeyboardState kb = {};
+
+// ==================== LUCA-STATUS ====================
+// Statusmodell, Decoder und Update-Politik teilt sich der T5 mit dem T-Deck
+// (luca_core/luca_status.h), hier für E-Paper ohne LoRa spezialisiert.
+// Resonanz 6 = Polarlicht-Orange, Transformation, 6. Sinn
+typedef LucaBoardT5 LucaBoard;
+
+LucaStatus luca = LUCA_STATUS_INITIAL;
+
+// ==================== OUTBOX (überlebt Deep-Sleep) ====================
+// Gesendete Nachrichten landen sofort hier und gehen gesammelt in einem
+// POST raus, sobald ohnehin WiFi für das Status-Update aufgebaut ist.
+// Ist die Queue voll, fällt die älteste Nachricht heraus.
+#define OUTBOX_SLOTS 8
+#define OUTBOX_BODY_MAX 3328  // JSON für 8 Texte à 63 Zeichen, auch voll escaped
+
+struct OutboxEntry {
+  char text[64];
+  uint8_t resonance;
+};
+
+struct Outbox {
+  uint8_t first;  // Älteste Nachricht
+  uint8_t count;
+  OutboxEntry entries[OUTBOX_SLOTS];
+};
+
+RTC_DATA_ATTR Outbox outbox = {};
+
+// ==================== TOUCH-EVENTS ====================
+QueueHandle_t touch_events;  // ISR → loop(), siehe touch_isr()
+
+// ==================== WARM-WAKE (überlebt Deep-Sleep) ====================
+// Status, Tastatur-Puffer und das zuletzt gezeichnete Bild im RTC-Slow-Memory.
+// Das Panel hält sein Bild ohne Strom; nach dem Wake bekommt der Treiber
+// seinen Framebuffer zurück, damit partielle Updates wieder auf dem
+// tatsächlichen Bildinhalt aufsetzen und kein Vollbild nötig ist.
+#define WARM_STATE_MAGIC 0x36904A09  // Bei jeder Layout-Änderung hochzählen
+
+struct WarmState {
+  uint32_t magic;
+  LucaStatus luca;
+  KeyboardState kb;
+  uint16_t partial_count;  // Partielle Updates seit dem letzten Vollbild
+  // Was das Panel gerade zeigt (1 Bit/Pixel, ~3,9 KB von 8 KB RTC-Slow-Memory).
+  // Zugleich Referenz für das Diff-Update, wortweise für den XOR-Vergleich.
+  uint32_t frame[EPD_FB_BYTES / 4];
+};
+
+RTC_DATA_ATTR WarmState warm_state = {};
+
+// ==================== WIFI-CACHE (überlebt Deep-Sleep) ====================
+// Letzter AP (BSSID + Kanal) und DHCP-Lease im RTC-Slow-Memory. Beim
+// nächsten Wake wird direkt dieser AP auf diesem Kanal mit statischer IP
+// angesprochen: kein Scan, kein DHCP-Handshake.
+#define WIFI_CACHE_MAGIC 0x36903690
+
+struct WifiCache {
+  uint32_t magic;
+  uint8_t bssid[6];
+  int32_t channel;
+  uint32_t ip, gateway, subnet, dns;
+};
+
+RTC_DATA_ATTR WifiCache wifi_cache = {};
+
+// Läuft gerade ein Verbindungsaufbau aus wifi_start()? (0 = nein)
+unsigned long wifi_started_ms = 0;
+
+// ==================== ESP-NOW-GATEWAY (überlebt Deep-Sleep) ====================
+// Läuft in der Nähe ein T-Deck im Gateway-Modus, kommen Status und Outbox-
+// Quittung per ESP-NOW: ein Paket hin, eins zurück, ohne Assoziation, DHCP
+// oder TCP (luca_core/luca_espnow.h). Antwortet niemand, geht es wie bisher
+// über WiFi + HTTP. Gesucht wird per Broadcast auf dem Kanal aus dem
+// WiFi-Cache; Nachrichten gehen nur an ein bekanntes Gateway, damit nie
+// zwei T-Decks dieselbe Nachricht weiterreichen.
+struct GatewayCache {
+  bool known;           // MAC des Gateways bekannt, sonst Broadcast
+  uint8_t mac[6];
+  uint16_t seq;         // Zählt pro Anfrage, das Gateway erkennt Wiederholungen
+  uint32_t generation;  // Generation des Status in `luca`
+};
+
+RTC_DATA_ATTR GatewayCache gateway = {false, {0}, 0, LUCA_ESPNOW_NO_GENERATION};
+
+// Antwortpuffer, gefüllt im ESP-NOW-Callback (WiFi-Task)
+uint8_t espnow_reply[LUCA_ESPNOW_MAX];
+uint8_t espnow_reply_mac[6];
+volatile int espnow_reply_len = 0;
+
+// ==================== ADAPTIVE KADENZ (überlebt Deep-Sleep) ====================
+// Unveränderter Status verdoppelt das Intervall bis STATUS_MAX_MS,
+// Änderungen und Touch-Bedienung holen es auf STATUS_INTERVAL_MS zurück.
+// Ein X-Next-Poll-Ms vom Server gilt vor dem Backoff, schwache Batterie
+// streckt zusätzlich (luca_core/luca_cadence.h).
+RTC_DATA_ATTR LucaCadence cadence = {};
+RTC_DATA_ATTR uint32_t status_interval_ms = STATUS_INTERVAL_MS;
+
+// ETag des Status in `luca`: damit fragt der nächste Abruf bedingt an und
+// bekommt bei unverändertem Status nur ein 304 ohne Body zurück
+RTC_DATA_ATTR char status_etag[48] = "";
+
+// Boot-Metrik: Kaltstart bis zum ersten Bild mit echtem Status. Warm-Wakes
+// zählen nicht, dort steht das letzte Bild ja noch.
+bool boot_frame_pending = false;
+
+// ==================== TLS-SESSION (überlebt Deep-Sleep) ====================
+// Bei https:// bleibt die ausgehandelte Session (Ticket bzw. Session-ID)
+// im RTC-Memory. Der nächste Wake setzt sie fort: ein Round-Trip, keine
+// ECDHE- und Signatur-Rechnung, nur beim ersten Verbinden der volle
+// Handshake. ~2,1 KB, zusammen mit WARM-WAKE und Outbox ~6,8 KB von 8 KB.
+RTC_DATA_ATTR LucaTlsSession tls_session = {};
+LucaTlsClient tls_client;
 
 // ==================== SETUP ====================
 void setup() {
@@ -75,49 +226,78 @@ void setup() {
   epd_init();
   epd_poweron();
 
-  // WiFi nur kurz für Status-Update
-  WiFi.begin(WIFI_SSID, WIFI_PASS);
-  delay(2000);  // Schneller Timeout
+  bool warm = warm_state_restore();
+  boot_frame_pending = !warm;
+  if (cadence.base_ms == 0) lucaCadenceInit(cadence, STATUS_INTERVAL_MS, STATUS_MAX_MS);
 
-  // Erstes Mal: Vollbild zeichnen
-  draw_full_screen();
-  epd_update();
+  // WiFi erst bei Bedarf: mit Gateway in der Nähe wird es gar nicht gebraucht.
+  // Nur beim Kaltstart (RTC leer, kein Gateway, kein Kanal) läuft die
+  // Assoziation schon parallel zum Vollbild-Refresh an.
+  if (!warm) wifi_start();
 
-  // Touch wakeup konfigurieren
-  esp_sleep_enable_touchpad_wakeup();
+  if (warm && esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER) {
+    // Timer-Wake: Panel zeigt noch das alte Bild → Status-Zone nur
+    // auffrischen, wenn sich etwas geändert hat (304 = kein Refresh)
+    if (update_luca_status(false)) draw_zone(4, true);
+    enter_deep_sleep();
+  }
+
+  if (!warm) {
+    // Kaltstart: Vollbild zeichnen (draw_full_screen() macht das epd_update())
+    draw_full_screen();
+  }
+
+  // Touch per INT-Leitung statt I2C-Polling
+  touch_begin();
 
   Serial.println("[LUCA-T5] Setup complete. Entering loop...");
 }
 
 // ==================== LOOP (power-optimized) ====================
 void loop() {
-  // 1. Touch prüfen (non-blocking)
-  if (touch_touched()) {
+  // 1. Touch-Events aus der INT-Queue abarbeiten (Debounce in handle_touch())
+  uint8_t event;
+  while (xQueueReceive(touch_events, &event, 0) == pdTRUE) {
     handle_touch();
-    delay(200);  // Debounce
   }
 
-  // 2. Periodischer Update (alle 3.69s)
+  // 2. Periodischer Update (aktiv bedient → Basis-Intervall). Der erste
+  // kommt sofort; nach dem Kaltstart geht der erste echte Status auch
+  // ohne Änderung ins Bild. Kam nichts an (kein WiFi, kein Gateway),
+  // bleibt die Boot-Metrik offen bis zum nächsten Versuch.
   static unsigned long last_update = 0;
-  if (millis() - last_update > 3690) {
-    update_luca_status();
-    draw_zone(4, true);  // Zone 4 (Mitte) = Haupt-Status
+  static bool first_update = true;
+  if (first_update || millis() - last_update > status_interval_ms) {
+    bool changed = update_luca_status(true);
+    bool first_status = boot_frame_pending && luca.updated_ms != 0;
+    if (changed || first_status) {
+      draw_zone(4, true);  // Zone 4 (Mitte) = Haupt-Status
+    }
+    if (first_status) {
+      boot_frame_pending = false;
+      Serial.printf("[LUCA-T5] Boot: erstes Status-Bild nach %lu ms\n", millis());
+    }
+    first_update = false;
     last_update = millis();
   }
 
   // 3. Wenn inaktiv → Deep Sleep
-  if (millis() - kb.last_key_time > 10000) {  // 10s Inaktivität
+  if (millis() - kb.last_key_time > IDLE_SLEEP_MS) {
     enter_deep_sleep();
   }
 
-  delay(100);
+  // 4. Light-Sleep bis zum nächsten Touch, Status-Update oder Deep-Sleep
+  unsigned long now = millis();
+  unsigned long until_update = last_update + status_interval_ms - now;
+  unsigned long until_idle = kb.last_key_time + IDLE_SLEEP_MS - now;
+  touch_light_sleep(min(until_update, until_idle) + 1);
 }
 
 // ==================== EFFIZIENTE DISPLAY-FUNKTIONEN ====================
 void draw_full_screen() {
   // Header (Zone 0-2)
   epd_clear_framebuffer();
-  epd_fill_rect(0, 0, EPD_WIDTH, 20, 0);  // Schwarzer Header
+  epd_fill_rect(LUCA_T5_HEADER.x, LUCA_T5_HEADER.y, LUCA_T5_HEADER.width, LUCA_T5_HEADER.height, 0);  // Schwarzer Header
   epd_draw_text(5, 5, "[LUCA-AI-369-T5]", 1);
   epd_draw_text(210, 5, "EFF", 1);
 
@@ -128,11 +308,12 @@ void draw_full_screen() {
   draw_keyboard();
 
   // Nur einmal voll updaten
-  epd_update();
+  epd_full_refresh();
 }
 
 void draw_zone(int zone_index, bool partial_update) {
-  DisplayArea& zone = update_zones[zone_index];
+  const DisplayArea& zone = update_zones[zone_index];
+  dirty_zones |= 1 << zone_index;
 
   switch(zone_index) {
     case 4:  // Mitte = Haupt-Status
@@ -146,172 +327,617 @@ void draw_zone(int zone_index, bool partial_update) {
       snprintf(buf, sizeof(buf), "%d", luca.resonance);
       epd_draw_text(zone.x + 75, zone.y + 5, buf, 1);
 
-      if (luca.life_active) {
+      if (luca.alive) {
         epd_fill_circle(zone.x + 110, zone.y + 8, 3, 1);
       }
       break;
   }
 
   if (partial_update) {
-    epd_update_area(zone.x, zone.y, zone.width, zone.height);
+    epd_flush();
   }
 }
 
 void draw_keyboard() {
   // Nur Tastatur-Bereich (Zone 6-8)
-  DisplayArea& kb_zone = update_zones[6];  // Unterster Bereich
-
-  epd_fill_rect(0, 95, EPD_WIDTH, 27, 255);  // Clear Keyboard area
+  const LucaRect& area = LUCA_T5_KEYBOARD;
+  epd_fill_rect(area.x, area.y, area.width, area.height, 255);  // Clear Keyboard area
+  dirty_zones |= LUCA_T5_KEYBOARD_ZONES;
 
-  // Zeichne Grid
-  for (int row = 0; row < KEYBOARD_ROWS; row++) {
-    for (int col = 0; col < KEYBOARD_COLS; col++) {
-      int x = col * KEY_WIDTH;
-      int y = 95 + row * KEY_HEIGHT;
+  // Zeichne Grid; Tasten sind 27-28 px breit, damit rechts nichts übrig bleibt
+  for (int key = 0; key < LUCA_T5_KEYS; key++) {
+    const LucaRect& rect = LUCA_T5_KEY_RECTS.cells[key];
 
-      // Tasten-Rahmen
-      epd_draw_rect(x, y, KEY_WIDTH, KEY_HEIGHT, 1);
+    // Tasten-Rahmen
+    epd_draw_rect(rect.x, rect.y, rect.width, rect.height, 1);
 
-      // Tasten-Label
-      char label[2] = {keyboard[row][col], '\0'};
-      epd_draw_text(x + 3, y + 1, label, 1);
+    // Tasten-Label
+    char label[2] = {keyboard[key / KEYBOARD_COLS][key % KEYBOARD_COLS], '\0'};
+    epd_draw_text(rect.x + 3, rect.y + 1, label, 1);
 
-      // 3-6-9 Markierung
-      if ((row * KEYBOARD_COLS + col + 1) % 3 == 0) {
-        epd_draw_pixel(x + KEY_WIDTH - 2, y + 1, 1);
-      }
+    // 3-6-9 Markierung
+    if ((key + 1) % 3 == 0) {
+      epd_draw_pixel(rect.x + rect.width - 2, rect.y + 1, 1);
     }
   }
 
   // Ausgewählte Taste invertieren
-  int sel_x = kb.selected_col * KEY_WIDTH;
-  int sel_y = 95 + kb.selected_row * KEY_HEIGHT;
-  epd_invert_area(sel_x + 1, sel_y + 1, KEY_WIDTH - 2, KEY_HEIGHT - 2);
+  const LucaRect& sel = LUCA_T5_KEY_RECTS.cells[kb.selected_row * KEYBOARD_COLS + kb.selected_col];
+  epd_invert_area(sel.x + 1, sel.y + 1, sel.width - 2, sel.height - 2);
+}
 
-  epd_update_area(0, 95, EPD_WIDTH, 27);  // Nur Keyboard-Area updaten
+// ==================== DIFF-UPDATE ====================
+// warm_state.frame ist immer genau das, was das Panel zeigt. epd_flush()
+// vergleicht den Treiber-Framebuffer wortweise per XOR damit, sammelt pro
+// Zone die Bounding-Box geänderter Pixel, fasst Boxen zusammen, wenn ein
+// gemeinsamer Refresh kaum größer ist, und aktualisiert nur diese Bereiche.
+// Der Vergleich selbst steckt in luca_core/luca_epd_diff.h (auch nativ
+// gebenchmarkt, siehe apps/t-deck/bench). Verglichen werden nur die
+// Zonen-Zeilen, in die seit dem letzten Flush gezeichnet wurde.
+#define EPD_MERGE_SLACK_PX (83 * 40 / 4)  // Mehrfläche, die ein eingespartes Update wert ist
+
+static_assert(EPD_ROW_BYTES == (EPD_WIDTH + 31) / 32 * 4, "Zeilen müssen wortweise vergleichbar sein");
+
+// Geänderte Bereiche pro Zone bestimmen; liefert die Anzahl nicht-leerer Boxen
+int epd_diff(DirtyBox boxes[9], uint16_t zones) {
+  return lucaEpdDiff((const uint32_t*)epd_get_framebuffer(), warm_state.frame,
+                     EPD_WIDTH, EPD_HEIGHT, update_zones, boxes, zones);
+}
+
+// Die verglichenen Zonen-Zeilen als angezeigt übernehmen
+void epd_mark_shown(uint16_t zones) {
+  uint8_t rows = lucaZoneRows(zones);
+  for (int r = 0; r < 3; r++) {
+    if (!(rows & (1 << r))) continue;
+    int y0 = update_zones[r * 3].y;
+    int y1 = r < 2 ? update_zones[(r + 1) * 3].y : EPD_HEIGHT;
+    memcpy((uint8_t*)warm_state.frame + y0 * EPD_ROW_BYTES,
+           epd_get_framebuffer() + y0 * EPD_ROW_BYTES, (y1 - y0) * EPD_ROW_BYTES);
+  }
+}
+
+void epd_full_refresh() {
+  epd_update();
+  memcpy(warm_state.frame, epd_get_framebuffer(), EPD_FB_BYTES);
+  warm_state.partial_count = 0;
+  dirty_zones = 0;
+}
+
+// Nur geänderte Pixel ans Panel schicken
+void epd_flush() {
+  uint16_t zones = dirty_zones;
+  dirty_zones = 0;
+
+  DirtyBox boxes[9];
+  int count = epd_diff(boxes, zones);
+  if (count == 0) return;
+
+  if (warm_state.partial_count >= EPD_FULL_REFRESH_EVERY) {
+    epd_full_refresh();
+    return;
+  }
+
+  count = lucaEpdMerge(boxes, count, EPD_MERGE_SLACK_PX);
+  for (int i = 0; i < count; i++) {
+    epd_update_area(boxes[i].x0, boxes[i].y0,
+                    boxes[i].x1 - boxes[i].x0 + 1, boxes[i].y1 - boxes[i].y0 + 1);
+  }
+  warm_state.partial_count++;
+  epd_mark_shown(zones);
 }
 
 // ==================== TOUCH-HANDLING (effizient) ====================
-bool touch_touched() {
-  // I2C Touch-Check (schnell, non-blocking)
-  Wire.beginTransmission(0x5D);
-  return Wire.endTransmission() == 0;
+// Der GT911 zieht INT bei jedem neuen Touch-Report kurz auf Low. Die ISR
+// legt nur ein Event in die Queue; I2C wird erst gelesen, wenn wirklich
+// ein Report ansteht.
+void IRAM_ATTR touch_isr() {
+  uint8_t event = 1;
+  BaseType_t woken = pdFALSE;
+  xQueueSendFromISR(touch_events, &event, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void touch_begin() {
+  touch_events = xQueueCreate(8, sizeof(uint8_t));
+  Wire.begin(TOUCH_SDA, TOUCH_SCL);
+
+  // Nach einem EXT0-Wake ist der Pin noch RTC-IO → zurück an die GPIO-Matrix
+  rtc_gpio_deinit(TOUCH_INT_PIN);
+  pinMode(TOUCH_INT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(TOUCH_INT_PIN), touch_isr, FALLING);
+
+  // Der Touch, der das Gerät geweckt hat, ist das erste Event
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0) {
+    uint8_t event = 1;
+    xQueueSend(touch_events, &event, 0);
+  }
+}
+
+// Light-Sleep bis INT auf Low geht oder timeout_ms abgelaufen ist
+void touch_light_sleep(unsigned long timeout_ms) {
+  if (uxQueueMessagesWaiting(touch_events) > 0) return;
+
+  Serial.flush();  // UART-Ausgabe geht sonst im Light-Sleep verloren
+  // gpio_wakeup_enable() stellt den Pin auf Level-Interrupt um: ohne Maske
+  // feuert touch_isr() bei gehaltenem INT immer wieder und flutet die Queue
+  gpio_intr_disable(TOUCH_INT_PIN);
+  gpio_wakeup_enable(TOUCH_INT_PIN, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup((uint64_t)timeout_ms * 1000);
+
+  esp_light_sleep_start();
+
+  // Zurück auf Flanke, erst dann wieder freigeben
+  gpio_wakeup_disable(TOUCH_INT_PIN);
+  gpio_set_intr_type(TOUCH_INT_PIN, GPIO_INTR_NEGEDGE);
+  gpio_intr_enable(TOUCH_INT_PIN);
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+
+  // Im Light-Sleep feuert die Flanken-ISR nicht; Wake-Grund selbst melden
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+    uint8_t event = 1;
+    xQueueSend(touch_events, &event, 0);
+  }
+}
+
+// Bis das Statusregister wieder 0 ist, hält der GT911 INT und schickt
+// keine neuen Reports
+void gt911_clear_status() {
+  Wire.beginTransmission(GT911_ADDR);
+  Wire.write(GT911_STATUS >> 8);
+  Wire.write(GT911_STATUS & 0xFF);
+  Wire.write((uint8_t)0);
+  Wire.endTransmission();
 }
 
 void handle_touch() {
-  // Lese Touch-Koordinaten (5 Byte Protocol)
-  Wire.requestFrom(0x5D, 5);
-  if (Wire.available() < 5) return;
+  // Ab 0x814E lesen: Status, dann Punkt 1 (Track-ID, X und Y little-endian)
+  Wire.beginTransmission(GT911_ADDR);
+  Wire.write(GT911_STATUS >> 8);
+  Wire.write(GT911_STATUS & 0xFF);
+  if (Wire.endTransmission(false) != 0) return;
+  if (Wire.requestFrom(GT911_ADDR, 6) != 6) return;
 
-  uint8_t data[5];
-  for (int i = 0; i < 5; i++) data[i] = Wire.read();
+  uint8_t data[6];
+  for (int i = 0; i < 6; i++) data[i] = Wire.read();
 
-  if (data[0] != 0x01) return;  // Kein Touch
+  if (!(data[0] & 0x80)) return;  // Kein neuer Report
+  gt911_clear_status();
+  if ((data[0] & 0x0F) == 0) return;  // Finger losgelassen
 
-  int x = (data[1] << 8) | data[2];
-  int y = (data[3] << 8) | data[4];
+  int x = data[2] | (data[3] << 8);
+  int y = data[4] | (data[5] << 8);
 
   // Nur verarbeiten wenn >200ms seit letztem Key vergangen
   if (millis() - kb.last_key_time < 200) return;
 
-  // Tastatur-Bereich?
-  if (y < 95 || y > 122) return;
-
-  int col = x / KEY_WIDTH;
-  int row = (y - 95) / KEY_HEIGHT;
+  // Taste per Lookup-Tabelle, -1 außerhalb der Tastatur
+  int key = lucaT5KeyAt(x, y);
+  if (key < 0) return;
 
-  if (row >= 0 && row < KEYBOARD_ROWS && col >= 0 && col < KEYBOARD_COLS) {
-    kb.selected_row = row;
-    kb.selected_col = col;
-    handle_key_press(row, col);
-    kb.last_key_time = millis();
-  }
+  kb.selected_row = key / KEYBOARD_COLS;
+  kb.selected_col = key % KEYBOARD_COLS;
+  handle_key_press(kb.selected_row, kb.selected_col);
+  kb.last_key_time = millis();
 }
 
 // ==================== TASTATUR-AKTIONEN (minimal) ====================
 void handle_key_press(int row, int col) {
   char key = keyboard[row][col];
 
-  if (key == '↵') {  // SENDEN
+  if (key == KEY_SEND) {  // SENDEN
     if (kb.cursor > 0) {
-      send_message_to_luca();
-      draw_zone(4, true);  // Status updaten
+      outbox_push(kb.buffer);  // Geht mit dem nächsten Status-Update raus
     }
     // Buffer leeren
     kb.cursor = 0;
     memset(kb.buffer, 0, sizeof(kb.buffer));
-    draw_full_screen();  // Einmalig voll updaten
   } else if (kb.cursor < 63) {
     // Zeichen hinzufügen
     kb.buffer[kb.cursor++] = key;
-    draw_zone(4, true);  // Nur Status-Zone updaten
   }
+
+  // Auswahl und Status neu zeichnen; epd_flush() schickt nur, was sich geändert hat
+  draw_keyboard();
+  draw_zone(4, true);
 }
 
 // ==================== LUCA-API (effizient) ====================
-void update_luca_status() {
-  if (WiFi.status() != WL_CONNECTED) return;
+// Holt den Status und legt das nächste Intervall fest.
+// true = Status hat sich geändert, Zone 4 muss neu gezeichnet werden.
+bool update_luca_status(bool interacting) {
+  LucaStatus before = luca;
+  uint32_t hint_ms = 0;
+
+  // Erst der Gateway (zwei Frames), dann selbst per WiFi
+  LucaLinks links = {true, false, wifi_cache.magic == WIFI_CACHE_MAGIC, false};
+  LucaSource source = lucaStatusSource<LucaBoard>(links);
+  if (source == LUCA_SOURCE_GATEWAY && !gateway_exchange(hint_ms)) {
+    source = lucaStatusSource<LucaBoard>(links, LUCA_SOURCE_BIT(LUCA_SOURCE_GATEWAY));
+  }
+  if (source == LUCA_SOURCE_HTTP) hint_ms = fetch_luca_status();
+
+  // Nur was Zone 4 zeigt zählt: spart Refreshes und streckt den Backoff
+  bool changed = lucaStatusChanged<LucaBoard>(before, luca);
+  lucaCadenceBattery(cadence, battery_millivolts());
+  status_interval_ms = lucaCadenceNext(cadence, changed, interacting, hint_ms);
+  return changed;
+}
+
+// http:// wie gehabt, https:// über tls_client mit Pin und RTC-Session.
+// Beide Requests eines Wakes teilen die Session, auch der zweite ist kurz.
+bool http_begin(HTTPClient& http, const char* url) {
+  if (strncmp(LUCA_SERVER, "https://", 8) != 0) return http.begin(url);
+
+  uint8_t pin[LUCA_TLS_PIN_LEN];
+  if (!lucaTlsParsePin(LUCA_SERVER_PIN, pin)) {
+    Serial.println("[LUCA-T5] https:// ohne gültigen LUCA_SERVER_PIN");
+    return false;
+  }
+  tls_client.setPin(pin);
+  tls_client.setSession(&tls_session);
+  return http.begin(tls_client, url);
+}
+
+// Rückgabe: X-Next-Poll-Ms des Servers, 0 = kein Hinweis (oder kein WiFi)
+uint32_t fetch_luca_status() {
+  if (!wifi_connect()) return 0;
+
+  // Wartende Nachrichten zuerst, damit der Status ihre Wirkung schon zeigt
+  outbox_flush();
 
   HTTPClient http;
   http.setTimeout(2000);  // Kurzer Timeout
 
-  String url = String(LUCA_SERVER) + "/api/status?op=" + LUCA_OPERATOR + "&ver=" + LUCA_VERSION;
+  // fmt=bin: 22-Byte Binär-Frame statt JSON (siehe luca_status_frame.h).
+  // Die URL ist konstant und steht schon beim Kompilieren fest.
+  static const char url[] = LUCA_SERVER "/api/t5/status?op=" LUCA_OPERATOR "&ver=" LUCA_VERSION "&fmt=bin";
 
-  http.begin(url);
+  if (!http_begin(http, url)) {
+    WiFi.disconnect();
+    return 0;
+  }
+  const char* response_headers[] = {"X-Next-Poll-Ms", "ETag"};
+  http.collectHeaders(response_headers, 2);
+  if (status_etag[0]) http.addHeader("If-None-Match", status_etag);
   int httpCode = http.GET();
+  bool answered = httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NOT_MODIFIED;
+  uint32_t hint_ms = answered ? http.header("X-Next-Poll-Ms").toInt() : 0;
+  // 304: `luca` ist noch aktuell, nichts zu parsen
+
+  if (httpCode == HTTP_CODE_OK && peek_body(http.getStreamPtr()) == LUCA_FRAME_MAGIC) {
+    // Binär-Frame direkt vom Socket dekodieren, ohne ArduinoJson
+    uint8_t frame_buf[LUCA_FRAME_SIZE];
+    LucaStatusFrame frame;
+    size_t len = http.getStreamPtr()->readBytes(frame_buf, sizeof(frame_buf));
+
+    if (lucaFrameDecode(frame_buf, len, frame) == LUCA_FRAME_OK) {
+      lucaStatusFromFrame(luca, frame, millis());
+      strlcpy(status_etag, http.header("ETag").c_str(), sizeof(status_etag));
+      gateway.generation = frame.generation;
+    }
+  } else if (httpCode == HTTP_CODE_OK) {
+    // Älterer Server ohne Binär-Format → JSON, direkt vom Socket statt
+    // über einen String; der Filter behält nur die Status-Felder
+    StaticJsonDocument<192> filter;
+    for (const char* key : {"consciousness_level", "consciousness", "quantum_coherence", "akashic_connection",
+                            "generation", "node_count", "resonance", "is_alive", "life_active"}) {
+      filter[key] = true;
+    }
+    StaticJsonDocument<384> doc;
+    DeserializationError error = deserializeJson(doc, http.getStream(), DeserializationOption::Filter(filter));
 
-  if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
-    StaticJsonDocument<128> doc;
-    deserializeJson(doc, payload);
-
-    luca.consciousness = doc["consciousness"] | luca.consciousness;
-    luca.resonance = doc["resonance"] | luca.resonance;
-    luca.life_active = luca.consciousness > 36.9;
+    lucaStatusApplyJson(luca, doc, millis());
+    gateway.generation = LUCA_ESPNOW_NO_GENERATION;  // JSON kennt keine Generation
+    // Nur ein vollständig gelesener Status darf per 304 bestätigt werden
+    if (!error) strlcpy(status_etag, http.header("ETag").c_str(), sizeof(status_etag));
   }
 
   http.end();
   WiFi.disconnect();  // Strom sparen
+  return hint_ms;
 }
 
-void send_message_to_luca() {
-  if (kb.cursor == 0) return;
+// Erstes Body-Byte ansehen ohne es zu verbrauchen (wartet max. 2s)
+int peek_body(WiFiClient* stream) {
+  unsigned long start = millis();
+  while (stream->connected() && millis() - start < 2000) {
+    int c = stream->peek();
+    if (c >= 0) return c;
+    delay(1);
+  }
+  return -1;
+}
 
-  WiFi.begin(WIFI_SSID, WIFI_PASS);
-  delay(1000);  // Kurz warten
+void outbox_push(const char* text) {
+  if (outbox.count == OUTBOX_SLOTS) {
+    Serial.println("[LUCA-T5] Outbox voll, älteste Nachricht verworfen");
+    outbox.first = (outbox.first + 1) % OUTBOX_SLOTS;
+    outbox.count--;
+  }
+
+  OutboxEntry& entry = outbox.entries[(outbox.first + outbox.count) % OUTBOX_SLOTS];
+  strlcpy(entry.text, text, sizeof(entry.text));
+  entry.resonance = luca.resonance;
+  outbox.count++;
+}
 
-  if (WiFi.status() != WL_CONNECTED) return;
+// Alle wartenden Nachrichten als ein Batch-POST; WiFi muss schon stehen.
+// Nur bei HTTP 200 wird die Queue geleert, sonst beim nächsten Wake erneut.
+void outbox_flush() {
+  if (outbox.count == 0) return;
 
   HTTPClient http;
   http.setTimeout(3000);
-  http.begin(String(LUCA_SERVER) + "/api/message");
+  if (!http_begin(http, LUCA_SERVER "/api/t5/messages")) return;
   http.addHeader("Content-Type", "application/json");
 
-  StaticJsonDocument<128> doc;
-  doc["message"] = kb.buffer;
+  // Texte als const char* → ArduinoJson speichert nur Zeiger, keine Kopien
+  StaticJsonDocument<JSON_OBJECT_SIZE(2) + JSON_ARRAY_SIZE(OUTBOX_SLOTS) +
+                     OUTBOX_SLOTS * JSON_OBJECT_SIZE(2)> doc;
   doc["operator"] = LUCA_OPERATOR;
-  doc["resonance"] = luca.resonance;
+  JsonArray messages = doc.createNestedArray("messages");
+  for (int i = 0; i < outbox.count; i++) {
+    const OutboxEntry& entry = outbox.entries[(outbox.first + i) % OUTBOX_SLOTS];
+    JsonObject item = messages.createNestedObject();
+    item["message"] = (const char*)entry.text;
+    item["resonance"] = entry.resonance;
+  }
 
-  String json;
-  serializeJson(doc, json);
-  http.POST(json);
+  // Fester Puffer statt String: kein Heap, der über Wochen zerfasern kann
+  static char body[OUTBOX_BODY_MAX];
+  size_t len = serializeJson(doc, body, sizeof(body));
+  if (len == 0 || len >= sizeof(body) - 1) {
+    Serial.println("[LUCA-T5] Outbox: JSON passt nicht in den Puffer");
+    http.end();
+    return;
+  }
+  int httpCode = http.POST((uint8_t*)body, len);
   http.end();
 
-  WiFi.disconnect();
+  if (httpCode == HTTP_CODE_OK) {
+    Serial.printf("[LUCA-T5] Outbox: %d Nachrichten gesendet\n", outbox.count);
+    outbox.first = 0;
+    outbox.count = 0;
+  }
+}
+
+// ==================== ESP-NOW (Gateway) ====================
+void espnow_receive(const uint8_t* mac, const uint8_t* data, int len) {
+  if (espnow_reply_len || len > (int)sizeof(espnow_reply)) return;
+  memcpy(espnow_reply, data, len);
+  memcpy(espnow_reply_mac, mac, sizeof(espnow_reply_mac));
+  espnow_reply_len = len;
+}
+
+bool espnow_add_peer(const uint8_t* mac) {
+  esp_now_peer_info_t peer = {};
+  memcpy(peer.peer_addr, mac, sizeof(peer.peer_addr));
+  peer.channel = 0;  // Aktueller Kanal, siehe gateway_exchange()
+  peer.ifidx = WIFI_IF_STA;
+  return esp_now_add_peer(&peer) == ESP_OK;
+}
+
+// Eine Anfrage, eine Antwort. Mit with_messages hängt so viel Outbox an,
+// wie in ein Paket passt; quittierte Nachrichten fallen aus der Outbox.
+bool gateway_poll(const uint8_t* mac, bool with_messages, uint32_t& hint_ms) {
+  uint8_t packet[LUCA_ESPNOW_MAX];
+  LucaEspNowHeader head = {LUCA_ESPNOW_POLL, 0, ++gateway.seq, gateway.generation};
+  size_t len = lucaEspNowWriteHeader(packet, head);
+
+  int attached = 0;
+  while (with_messages && attached < outbox.count) {
+    const OutboxEntry& entry = outbox.entries[(outbox.first + attached) % OUTBOX_SLOTS];
+    size_t next = lucaEspNowAddMessage(packet, len, sizeof(packet), entry.text, entry.resonance);
+    if (next == 0) break;
+    len = next;
+    attached++;
+  }
+
+  espnow_reply_len = 0;
+  if (esp_now_send(mac, packet, len) != ESP_OK) return false;
+
+  unsigned long start = millis();
+  while (!espnow_reply_len && millis() - start < ESPNOW_REPLY_TIMEOUT_MS) delay(1);
+
+  LucaEspNowHeader reply;
+  if (!espnow_reply_len || !lucaEspNowReadHeader(espnow_reply, espnow_reply_len, reply) ||
+      reply.seq != head.seq) {
+    return false;
+  }
+
+  if (reply.type == LUCA_ESPNOW_STATUS) {
+    LucaStatusFrame frame;
+    if (lucaFrameDecode(espnow_reply + LUCA_ESPNOW_HEADER_SIZE,
+                        espnow_reply_len - LUCA_ESPNOW_HEADER_SIZE, frame) != LUCA_FRAME_OK) {
+      return false;
+    }
+    lucaStatusFromFrame(luca, frame, millis());
+    gateway.generation = frame.generation;
+    status_etag[0] = '\0';  // Gehört zum letzten HTTP-Abruf, nicht zu diesem Status
+  } else if (reply.type != LUCA_ESPNOW_UNCHANGED) {
+    return false;
+  }
+
+  int accepted = min((int)reply.count, attached);
+  outbox.first = (outbox.first + accepted) % OUTBOX_SLOTS;
+  outbox.count -= accepted;
+  if (accepted > 0) Serial.printf("[LUCA-T5] Outbox: %d Nachrichten ans Gateway\n", accepted);
+
+  hint_ms = reply.value;
+  return true;
+}
+
+// true = Gateway hat geantwortet, `luca` ist aktuell und kein WiFi nötig
+bool gateway_exchange(uint32_t& hint_ms) {
+  if (wifi_cache.magic != WIFI_CACHE_MAGIC) return false;  // Kanal unbekannt
+  if (wifi_started_ms) return false;  // Assoziation läuft schon, nicht abwürgen
+
+  WiFi.mode(WIFI_STA);
+  esp_wifi_set_channel(wifi_cache.channel, WIFI_SECOND_CHAN_NONE);
+  if (esp_now_init() != ESP_OK) return false;
+#if ESP_IDF_VERSION_MAJOR >= 5
+  // Arduino-Core 3.x: Absender steckt in esp_now_recv_info_t
+  esp_now_register_recv_cb([](const esp_now_recv_info_t* info, const uint8_t* data, int len) {
+    espnow_receive(info->src_addr, data, len);
+  });
+#else
+  esp_now_register_recv_cb(espnow_receive);
+#endif
+
+  static const uint8_t broadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+  const uint8_t* target = gateway.known ? gateway.mac : broadcast;
+  bool answered = espnow_add_peer(target) && gateway_poll(target, gateway.known, hint_ms);
+
+  if (answered && !gateway.known) {
+    // Gefunden: ab jetzt direkt, und die Outbox darf mit
+    memcpy(gateway.mac, espnow_reply_mac, sizeof(gateway.mac));
+    gateway.known = espnow_add_peer(gateway.mac);
+  }
+
+  // Restliche Outbox in weiteren Runden, solange das Gateway etwas annimmt
+  while (answered && gateway.known && outbox.count > 0) {
+    uint8_t before = outbox.count;
+    if (!gateway_poll(gateway.mac, true, hint_ms) || outbox.count == before) break;
+  }
+
+  esp_now_deinit();
+  WiFi.mode(WIFI_OFF);
+
+  if (!answered && gateway.known) {
+    Serial.println("[LUCA-T5] Gateway antwortet nicht, beim nächsten Mal Broadcast");
+    gateway.known = false;
+  }
+  return answered;
+}
+
+// ==================== WIFI (schnell) ====================
+// Auf Verbindung pollen statt fester delay()-Wartezeit; start = Beginn des Versuchs
+bool wifi_wait(unsigned long start, unsigned long timeout_ms) {
+  while (millis() - start < timeout_ms) {
+    wl_status_t status = WiFi.status();
+    if (status == WL_CONNECTED) return true;
+    if (status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL) return false;
+    delay(10);
+  }
+  return false;
+}
+
+void wifi_cache_store() {
+  memcpy(wifi_cache.bssid, WiFi.BSSID(), sizeof(wifi_cache.bssid));
+  wifi_cache.channel = WiFi.channel();
+  wifi_cache.ip = (uint32_t)WiFi.localIP();
+  wifi_cache.gateway = (uint32_t)WiFi.gatewayIP();
+  wifi_cache.subnet = (uint32_t)WiFi.subnetMask();
+  wifi_cache.dns = (uint32_t)WiFi.dnsIP();
+  wifi_cache.magic = WIFI_CACHE_MAGIC;
+}
+
+// Verbindungsaufbau anstoßen ohne zu warten; wifi_connect() holt ihn ab
+void wifi_start() {
+  WiFi.mode(WIFI_STA);
+  WiFi.persistent(false);  // Kein Flash-Schreiben bei jedem Connect
+
+  if (wifi_cache.magic == WIFI_CACHE_MAGIC) {
+    WiFi.config(IPAddress(wifi_cache.ip), IPAddress(wifi_cache.gateway),
+                IPAddress(wifi_cache.subnet), IPAddress(wifi_cache.dns));
+    WiFi.begin(WIFI_SSID, WIFI_PASS, wifi_cache.channel, wifi_cache.bssid, true);
+  } else {
+    WiFi.begin(WIFI_SSID, WIFI_PASS);
+  }
+  wifi_started_ms = millis() | 1;
+}
+
+bool wifi_connect() {
+  if (WiFi.status() == WL_CONNECTED) return true;
+
+  if (!wifi_started_ms) wifi_start();
+  unsigned long start = wifi_started_ms;
+  wifi_started_ms = 0;
+
+  if (wifi_cache.magic == WIFI_CACHE_MAGIC) {
+    if (wifi_wait(start, WIFI_FAST_TIMEOUT_MS)) return true;
+
+    // Cache veraltet (AP gewechselt, Kanal geändert, Lease weg) → voller Scan mit DHCP
+    Serial.println("[LUCA-T5] WiFi-Cache ungültig, voller Scan");
+    wifi_cache.magic = 0;
+    WiFi.disconnect();
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    WiFi.begin(WIFI_SSID, WIFI_PASS);
+    start = millis();
+  }
+
+  if (!wifi_wait(start, WIFI_FULL_TIMEOUT_MS)) return false;
+
+  wifi_cache_store();
+  return true;
 }
 
 // ==================== POWER MANAGEMENT ====================
+// Zellspannung in mV vom Fuel-Gauge, 0 = nicht lesbar (z.B. ohne Akku)
+uint32_t battery_millivolts() {
+  Wire.begin(TOUCH_SDA, TOUCH_SCL);  // Beim Timer-Wake noch nicht initialisiert
+  Wire.beginTransmission(BATTERY_GAUGE_ADDR);
+  Wire.write(BATTERY_GAUGE_VOLTAGE);
+  if (Wire.endTransmission(false) != 0) return 0;
+  if (Wire.requestFrom(BATTERY_GAUGE_ADDR, 2) != 2) return 0;
+
+  uint32_t lo = Wire.read();
+  return lo | ((uint32_t)Wire.read() << 8);
+}
+
+void warm_state_store() {
+  // warm_state.frame führt epd_flush() ohnehin mit
+  warm_state.luca = luca;
+  warm_state.kb = kb;
+  warm_state.magic = WARM_STATE_MAGIC;
+}
+
+// true = Zustand aus dem letzten Deep-Sleep wiederhergestellt
+bool warm_state_restore() {
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_UNDEFINED ||
+      warm_state.magic != WARM_STATE_MAGIC) {
+    return false;  // Kaltstart (Power-On/Reset)
+  }
+
+  luca = warm_state.luca;
+  kb = warm_state.kb;
+  kb.last_key_time = millis();  // millis() beginnt nach dem Wake bei 0
+  memcpy(epd_get_framebuffer(), warm_state.frame, EPD_FB_BYTES);
+
+  Serial.println("[LUCA-T5] Warm-Wake, Bild aus RTC-Memory");
+  return true;
+}
+
+// Heap-Zustand vor jedem Deep-Sleep. Der Heap startet mit jedem Wake
+// neu; bleibt die T5 per Touch lange wach, zeigt ein schrumpfender
+// größter Block bei gleichem freien Heap Fragmentierung.
+void heap_report() {
+  const uint32_t internal = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+  Serial.printf("[LUCA-T5] Heap: %u frei, größter Block %u, min %u; PSRAM %u von %u frei; Stack-Reserve %u\n",
+                (unsigned)heap_caps_get_free_size(internal), (unsigned)heap_caps_get_largest_free_block(internal),
+                (unsigned)heap_caps_get_minimum_free_size(internal),
+                (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM), (unsigned)heap_caps_get_total_size(MALLOC_CAP_SPIRAM),
+                (unsigned)uxTaskGetStackHighWaterMark(nullptr));
+}
+
 void enter_deep_sleep() {
   Serial.println("[LUCA-T5] Deep-Sleep... Wake on Touch");
+  heap_report();
+
+  warm_state_store();
 
   // Display ausschalten
   epd_poweroff();
 
-  // Touch als Wake-Up konfigurieren
-  esp_sleep_enable_touchpad_wakeup();
+  // Touch-INT als Wake-Up: dieselbe Leitung wie im Betrieb, low-aktiv
+  detachInterrupt(digitalPinToInterrupt(TOUCH_INT_PIN));
+  rtc_gpio_pullup_en(TOUCH_INT_PIN);
+  rtc_gpio_pulldown_dis(TOUCH_INT_PIN);
+  esp_sleep_enable_ext0_wakeup(TOUCH_INT_PIN, 0);
 
-  // Timer für periodischen Wake (optional)
-  esp_sleep_enable_timer_wakeup(WAKE_INTERVAL_US);
+  // Timer-Wake nach dem adaptiven Intervall
+  esp_sleep_enable_timer_wakeup((uint64_t)status_interval_ms * 1000);
 
   // In Deep Sleep gehen
   esp_deep_sleep_start();
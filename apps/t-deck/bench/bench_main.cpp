@@ -0,0 +1,309 @@
+/**
+ * LUCA T-Deck App - Host benchmarks for the luca_core logic
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Built by [env:native] (pio run -e native -t exec). Everything measured
+ * here is the same header-only code both firmwares run; only the timing
+ * and the synthetic inputs are host-side. Each case also checks its
+ * result, so a broken build fails instead of reporting a fast number.
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <luca_cadence.h>
+#include <luca_command.h>
+#include <luca_energy.h>
+#include <luca_epd_diff.h>
+#include <luca_layout.h>
+#include <luca_metrics.h>
+#include <luca_status.h>
+#include <luca_status_frame.h>
+
+// T5 panel and zone grid (luca_layout.h, as used by LUCA_T5_Efficient.ino)
+#define EPD_WIDTH LUCA_T5_WIDTH
+#define EPD_HEIGHT LUCA_T5_HEIGHT
+#define EPD_ROW_WORDS ((EPD_WIDTH + 31) / 32)
+#define EPD_WORDS (EPD_ROW_WORDS * EPD_HEIGHT)
+#define EPD_MERGE_SLACK_PX (83 * 40 / 4)
+
+static const LucaZone* const zones = LUCA_T5_ZONES.cells;
+
+// Keeps results observable so the optimizer cannot drop the work
+static volatile uint32_t sink;
+static int failures = 0;
+
+typedef std::chrono::steady_clock Clock;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("FAIL  %s\n", what);
+        failures++;
+    }
+}
+
+static void report(const char* name, long ops, Clock::duration elapsed, double bytes_per_op = 0) {
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / ops;
+    if (bytes_per_op > 0) {
+        printf("%-28s %10.1f ns/op %12.0f ops/s %8.1f MB/s\n", name, ns, 1e9 / ns,
+               bytes_per_op * 1e3 / ns);
+    } else {
+        printf("%-28s %10.1f ns/op %12.0f ops/s\n", name, ns, 1e9 / ns);
+    }
+}
+
+// ==================== STATUS FRAME ====================
+
+static void benchFrame(long ops) {
+    LucaStatusFrame in = {0.65f, 0.75f, 0.70f, 42.5f, 1234, 7, 6, true};
+    uint8_t buf[LUCA_FRAME_SIZE];
+    check(lucaFrameEncode(in, buf, sizeof(buf)) == LUCA_FRAME_SIZE, "frame encode");
+
+    LucaStatusFrame out = {};
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < ops; i++) {
+        buf[12] = (uint8_t)i;   // Defeats hoisting; CRC fails on purpose
+        sink += lucaFrameDecode(buf, sizeof(buf), out);
+    }
+    report("frame decode (crc reject)", ops, Clock::now() - start, LUCA_FRAME_SIZE);
+
+    start = Clock::now();
+    for (long i = 0; i < ops; i++) {
+        in.generation = (uint32_t)i;
+        sink += (uint32_t)lucaFrameEncode(in, buf, sizeof(buf));
+        sink += lucaFrameDecode(buf, sizeof(buf), out);
+    }
+    report("frame encode + decode", ops, Clock::now() - start, 2 * LUCA_FRAME_SIZE);
+    check(out.generation == (uint32_t)(ops - 1) && out.node_count == 7 && out.alive, "frame round trip");
+}
+
+// ==================== STATUS POLICY ====================
+
+static void benchPolicy(long ops) {
+    LucaLinks offline = {false, false, false, false};
+    LucaLinks t5 = {true, false, true, false};
+    check(lucaStatusSource<LucaBoardTDeck>(offline) == LUCA_SOURCE_DEMO &&
+          lucaStatusSource<LucaBoardT5>(offline) == LUCA_SOURCE_NONE &&
+          lucaStatusSource<LucaBoardT5>(t5) == LUCA_SOURCE_GATEWAY &&
+          lucaStatusSource<LucaBoardT5>(t5, LUCA_SOURCE_BIT(LUCA_SOURCE_GATEWAY)) == LUCA_SOURCE_HTTP,
+          "status source order");
+
+    // A generation bump repaints the TFT but not the e-paper
+    LucaStatus a = LUCA_STATUS_INITIAL;
+    LucaStatus b = a;
+    b.generation++;
+    check(lucaStatusChanged<LucaBoardTDeck>(a, b) && !lucaStatusChanged<LucaBoardT5>(a, b),
+          "status change per display");
+
+    int changed = 0;
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < ops; i++) {
+        b.consciousness_level = (float)(i & 1023) / 1023.0f;
+        b.consciousness = b.consciousness_level * LUCA_CONSCIOUSNESS_SCALE;
+        changed += lucaStatusChanged<LucaBoardTDeck>(a, b);
+        changed += lucaStatusChanged<LucaBoardT5>(a, b);
+    }
+    sink += changed;
+    report("status changed (both)", ops, Clock::now() - start);
+}
+
+// ==================== E-PAPER DIFF ====================
+
+static uint32_t shown[EPD_WORDS];
+static uint32_t next[EPD_WORDS];
+
+static void setPixel(uint32_t* fb, int x, int y) {
+    uint8_t* bytes = (uint8_t*)fb;
+    bytes[y * EPD_ROW_WORDS * 4 + x / 8] ^= 0x80 >> (x % 8);
+}
+
+static void benchDiffCase(const char* name, long ops, int expect_boxes,
+                          uint16_t zone_mask = LUCA_EPD_ALL_ZONES) {
+    LucaDirtyBox boxes[LUCA_EPD_ZONES];
+    int count = 0;
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < ops; i++) {
+        count = lucaEpdDiff(next, shown, EPD_WIDTH, EPD_HEIGHT, zones, boxes, zone_mask);
+        count = lucaEpdMerge(boxes, count, EPD_MERGE_SLACK_PX);
+        sink += count;
+    }
+    report(name, ops, Clock::now() - start, 2.0 * sizeof(shown));
+    if (expect_boxes >= 0) check(count == expect_boxes, name);
+}
+
+static void benchDiff(long ops) {
+    srand(369);
+    for (int i = 0; i < EPD_WORDS; i++) shown[i] = (uint32_t)rand() * 2654435761u;
+    memcpy(next, shown, sizeof(shown));
+    benchDiffCase("diff 250x122, unchanged", ops, 0);
+
+    // Status text rewritten in the centre zone
+    for (int y = 50; y < 70; y++) {
+        for (int x = 100; x < 150; x += 3) setPixel(next, x, y);
+    }
+    benchDiffCase("diff 250x122, zone 4", ops, 1);
+    // Only the status widget was drawn: the other zone rows are skipped
+    benchDiffCase("diff 250x122, zone 4 masked", ops, 1, LUCA_T5_STATUS_ZONES);
+
+    // Noise everywhere: worst case, every word differs
+    for (int i = 0; i < EPD_WORDS; i++) next[i] = ~shown[i];
+    benchDiffCase("diff 250x122, full frame", ops, -1);
+}
+
+// ==================== COMMAND PARSER ====================
+
+struct BenchCommand {
+    const char* name;
+};
+
+static const BenchCommand commands[] = {
+    {"WIFI"}, {"API"}, {"POLL"}, {"MQTT"}, {"STATUS"}, {"HISTORY"}, {"PERF"},
+};
+
+static void benchParser(long ops) {
+    static const char* const lines[] = {
+        "WIFI:MyNetwork,password123",
+        "  api : http://192.168.1.100:8000  ",
+        "status:json",
+        "PERF",
+        "unknown:x",
+    };
+    const int line_count = sizeof(lines) / sizeof(lines[0]);
+    const size_t command_count = sizeof(commands) / sizeof(commands[0]);
+
+    char line[160];
+    int found = 0;
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < ops; i++) {
+        strcpy(line, lines[i % line_count]);
+        char* name;
+        char* arg;
+        if (!lucaCommandSplit(line, name, arg)) continue;
+        const BenchCommand* cmd = lucaCommandFind(commands, command_count, name);
+        if (cmd) found++;
+        sink += arg ? (uint32_t)strlen(arg) : 0;
+    }
+    report("command split + lookup", ops, Clock::now() - start);
+    check(found == ops - ops / line_count, "command lookup");   // "unknown" is last
+}
+
+// ==================== TOUCH LOOKUP ====================
+
+static void benchKeyLookup(long ops) {
+    // Every table entry against a plain rectangle search over the key grid
+    int mismatches = 0;
+    for (int y = 0; y < LUCA_T5_HEIGHT; y++) {
+        for (int x = 0; x < LUCA_T5_WIDTH; x++) {
+            int expect = -1;
+            for (int k = 0; k < LUCA_T5_KEYS; k++) {
+                const LucaRect& r = LUCA_T5_KEY_RECTS.cells[k];
+                if (x >= r.x && x < r.x + r.width && y >= r.y && y < r.y + r.height) expect = k;
+            }
+            if (lucaT5KeyAt(x, y) != expect) mismatches++;
+        }
+    }
+    check(mismatches == 0, "key lookup table");
+
+    int hits = 0;
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < ops; i++) {
+        hits += lucaT5KeyAt((int)(i % LUCA_T5_WIDTH), (int)((i / 7) % LUCA_T5_HEIGHT)) >= 0;
+    }
+    sink += hits;
+    report("touch key lookup", ops, Clock::now() - start);
+}
+
+// ==================== ENERGY ====================
+
+static void benchEnergy(long ops) {
+    // 4 V at 100 mA for 1 s in 2 ms steps: 400 mJ, 400 mW
+    LucaEnergyMeter meter;
+    lucaEnergyReset(meter);
+    for (int i = 0; i <= 500; i++) lucaEnergySample(meter, 1, i * 2000, 4000, 100000);
+    check(meter.phases[1].energy_nj == 400000000u && lucaEnergyMeanMw(meter.phases[1]) == 400,
+          "energy integration");
+
+    lucaEnergyReset(meter);
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < ops; i++) {
+        lucaEnergySample(meter, (int)(i & 3), i * 2000, 3700 + (uint32_t)(i & 255), 80000 + (int32_t)(i & 4095));
+    }
+    sink += (uint32_t)lucaEnergyTotalNj(meter);
+    report("energy sample", ops, Clock::now() - start);
+}
+
+// ==================== METRICS ====================
+
+#define METRICS_WINDOW 720      // HISTORY_WINDOW on the T-Deck
+
+static uint16_t window[METRICS_WINDOW];
+
+static void benchMetrics(long ops) {
+    // Half the samples at 0.25, half at 0.75: mean 0.5, sigma 0.25
+    for (int i = 0; i < METRICS_WINDOW; i++) window[i] = i & 1 ? 49151 : 16384;
+    LucaMetricInputs in = {};
+    lucaMomentsScan(in.consciousness, window, METRICS_WINDOW);
+    lucaMomentsScan(in.coherence, window, METRICS_WINDOW);
+    in.peers = LUCA_PEERS_FULL;
+    LucaMetrics out = lucaMetricsCompute(in);
+    check(out.consciousness_level == 32768 && lucaMomentsStddev(in.consciousness) == 16383 &&
+          out.quantum_coherence == 16384 && out.akashic_connection == 46530, "metrics fixed point");
+
+    uint64_t naive = 0;
+    for (int i = 0; i < METRICS_WINDOW; i++) {
+        window[i] = (uint16_t)(rand() & 0xFFFF);
+        naive += (uint64_t)window[i] * window[i];
+    }
+    LucaMoments odd = {0, 0, 0};
+    lucaMomentsScan(odd, window, 5);    // Spans of any length, like the ring's two
+    lucaMomentsScan(odd, window + 5, METRICS_WINDOW - 5);
+    check(odd.count == METRICS_WINDOW && odd.sum_sq == naive, "moments scan");
+
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < ops; i++) {
+        LucaMoments m = {0, 0, 0};
+        window[i % METRICS_WINDOW] = (uint16_t)i;
+        lucaMomentsScan(m, window, METRICS_WINDOW);
+        sink += lucaMomentsStddev(m);
+    }
+    report("moments, 1 h window", ops, Clock::now() - start, METRICS_WINDOW * sizeof(uint16_t));
+}
+
+// ==================== CADENCE ====================
+
+static void benchCadence(long ops) {
+    LucaCadence cadence;
+    lucaCadenceInit(cadence, 5000, 120000);
+    uint32_t interval = 0;
+    Clock::time_point start = Clock::now();
+    for (long i = 0; i < ops; i++) {
+        lucaCadenceBattery(cadence, 3400 + (uint32_t)(i & 511));
+        interval = lucaCadenceNext(cadence, (i & 63) == 0, false, 0);
+        sink += interval;
+    }
+    report("cadence step", ops, Clock::now() - start);
+    check(interval >= 5000 && interval <= 120000 * LUCA_CADENCE_BATTERY_FACTOR, "cadence bounds");
+}
+
+int main(int argc, char** argv) {
+    // Optional scale factor for slow hosts or CI: bench 0.1
+    double scale = argc > 1 ? atof(argv[1]) : 1.0;
+    if (scale <= 0) scale = 1.0;
+
+    printf("LUCA core benchmarks (scale %.2f)\n", scale);
+    benchFrame((long)(2000000 * scale));
+    benchPolicy((long)(2000000 * scale));
+    benchDiff((long)(20000 * scale));
+    benchParser((long)(2000000 * scale));
+    benchKeyLookup((long)(5000000 * scale));
+    benchEnergy((long)(5000000 * scale));
+    benchMetrics((long)(200000 * scale));
+    benchCadence((long)(5000000 * scale));
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
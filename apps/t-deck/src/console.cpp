@@ -0,0 +1,74 @@
+/**
+ * LUCA T-Deck App - Serial command console
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "console.h"
+#include <Arduino.h>
+#include <luca_command.h>
+
+static const ConsoleCommand* table = nullptr;
+static size_t table_size = 0;
+
+static char line[CONSOLE_LINE_MAX + 1];
+static size_t line_len = 0;
+static bool line_overflow = false;
+
+static void printHelp() {
+    Serial.println("Commands:");
+    for (size_t i = 0; i < table_size; i++) {
+        Serial.print("  ");
+        Serial.println(table[i].usage);
+    }
+    Serial.println("  HELP");
+}
+
+static void dispatch(char* text) {
+    char* name;
+    char* arg;
+    if (!lucaCommandSplit(text, name, arg)) return;
+
+    if (strcasecmp(name, "HELP") == 0) {
+        printHelp();
+        return;
+    }
+
+    const ConsoleCommand* cmd = lucaCommandFind(table, table_size, name);
+    if (!cmd) {
+        Serial.print("⚠️  Unknown command: ");
+        Serial.println(name);
+    } else if (cmd->needs_arg && (!arg || *arg == '\0')) {
+        Serial.print("⚠️  Usage: ");
+        Serial.println(cmd->usage);
+    } else {
+        cmd->handler(arg);
+    }
+}
+
+void consoleBegin(const ConsoleCommand* commands, size_t count) {
+    table = commands;
+    table_size = count;
+}
+
+void consolePoll() {
+    // Only what has already arrived; a partial line waits for the next poll
+    for (int pending = Serial.available(); pending > 0; pending--) {
+        int c = Serial.read();
+        if (c < 0) break;
+
+        if (c == '\n' || c == '\r') {
+            if (line_overflow) {
+                Serial.printf("⚠️  Line longer than %d characters ignored\n", CONSOLE_LINE_MAX);
+            } else {
+                line[line_len] = '\0';
+                dispatch(line);
+            }
+            line_len = 0;
+            line_overflow = false;
+        } else if (line_len < CONSOLE_LINE_MAX) {
+            line[line_len++] = (char)c;
+        } else {
+            line_overflow = true;   // Drop the rest up to the newline
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * LUCA T-Deck App - Serial command console
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Lines are assembled byte by byte from whatever the UART already holds,
+ * so polling never waits for the rest of a line, and dispatched through
+ * a command table. Input lives in one fixed buffer; nothing on this path
+ * touches the heap.
+ */
+
+#ifndef LUCA_CONSOLE_H
+#define LUCA_CONSOLE_H
+
+#include <stddef.h>
+
+// Longest accepted line, e.g. "API:" plus a full NET_URL_MAX URL
+#define CONSOLE_LINE_MAX 160
+
+// "NAME" or "NAME:arg". arg is nullptr when the line had no ':', else
+// the (trimmed, writable) rest of the line inside the console buffer.
+typedef void (*ConsoleHandler)(char* arg);
+
+struct ConsoleCommand {
+    const char* name;       // Matched case-insensitively
+    const char* usage;      // Shown by HELP
+    bool needs_arg;
+    ConsoleHandler handler;
+};
+
+// Install the command table; HELP is built in and lists it
+void consoleBegin(const ConsoleCommand* commands, size_t count);
+
+// Consume buffered serial input and run every completed line
+void consolePoll();
+
+#endif // LUCA_CONSOLE_H
@@ -0,0 +1,174 @@
+/**
+ * LUCA T-Deck App - Energy profiling
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "energy.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <atomic>
+#include "i2c_bus.h"
+#include "seqlock.h"
+
+#define ENERGY_TASK_CORE 0
+#define ENERGY_TASK_STACK 3072
+#define ENERGY_TASK_PRIORITY 2
+#define ENERGY_SAMPLE_MS 2          // 500 Hz
+#define ENERGY_PUBLISH_MS 100
+
+// INA226 in the battery lead: shunt voltage only, 140 us conversions
+// averaged 16x, so each reading covers the ~2 ms since the last one and
+// short TX bursts are not missed between samples
+#define INA226_ADDR 0x40
+#define INA226_CONFIG 0x00
+#define INA226_SHUNT 0x01           // Signed, 2.5 uV/LSB
+#define INA226_MANUFACTURER 0xFE
+#define INA226_TI_ID 0x5449
+#define INA226_SHUNT_CONTINUOUS 0x4405
+#ifndef ENERGY_SHUNT_MOHM
+#define ENERGY_SHUNT_MOHM 100       // R100 on the common breakout boards
+#endif
+
+static TaskHandle_t sampler = nullptr;
+static SeqLock<EnergyReport> report;
+static std::atomic<bool> running{false};
+static std::atomic<bool> reset_pending{false};
+static std::atomic<uint8_t> active_phases{0};
+static std::atomic<uint32_t> polls{0};
+static uint8_t bat_pin = 0;
+static uint32_t bat_divider = 1;
+static bool has_shunt = false;
+
+static const char* const phase_names[ENERGY_PHASES] = {
+    "idle",
+    "render",
+    "fetch",
+    "wifi",
+};
+
+static bool inaWrite(uint8_t reg, uint16_t value) {
+    Wire.beginTransmission(INA226_ADDR);
+    Wire.write(reg);
+    Wire.write(value >> 8);
+    Wire.write(value & 0xFF);
+    return Wire.endTransmission() == 0;
+}
+
+static bool inaRead(uint8_t reg, uint16_t& value) {
+    Wire.beginTransmission(INA226_ADDR);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) return false;
+    if (Wire.requestFrom(INA226_ADDR, 2) != 2) return false;
+    value = (uint16_t)(Wire.read() << 8);
+    value |= Wire.read();
+    return true;
+}
+
+static bool probeShunt() {
+    uint16_t id = 0;
+    return inaRead(INA226_MANUFACTURER, id) && id == INA226_TI_ID &&
+           inaWrite(INA226_CONFIG, INA226_SHUNT_CONTINUOUS);
+}
+
+// Battery current in uA, discharge positive
+static int32_t readCurrentUa() {
+    uint16_t raw;
+    if (!has_shunt || !inaRead(INA226_SHUNT, raw)) return 0;
+    return (int32_t)(int16_t)raw * 2500 / ENERGY_SHUNT_MOHM;
+}
+
+static EnergyPhase currentPhase() {
+    uint8_t bits = active_phases.load(std::memory_order_relaxed);
+    return bits ? (EnergyPhase)(31 - __builtin_clz(bits)) : ENERGY_IDLE;
+}
+
+static void samplerTask(void*) {
+    EnergyReport window = {};
+    uint32_t polls_base = 0;
+    int64_t published_us = 0;
+    TickType_t wake = xTaskGetTickCount();
+    const TickType_t period = pdMS_TO_TICKS(ENERGY_SAMPLE_MS) ? pdMS_TO_TICKS(ENERGY_SAMPLE_MS) : 1;
+
+    for (;;) {
+        if (!running) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            wake = xTaskGetTickCount();
+            continue;
+        }
+        if (reset_pending.exchange(false)) {
+            lucaEnergyReset(window.meter);
+            polls_base = polls.load();
+        }
+
+        // Phase first: the interval up to now belongs to what just ran
+        EnergyPhase phase = currentPhase();
+        uint32_t mv = analogReadMilliVolts(bat_pin) * bat_divider;
+        int32_t ua = readCurrentUa();
+        int64_t now_us = esp_timer_get_time();
+        lucaEnergySample(window.meter, phase, now_us, mv, ua);
+
+        if (now_us - published_us >= ENERGY_PUBLISH_MS * 1000) {
+            window.polls = polls.load() - polls_base;
+            window.current = has_shunt;
+            report.write(window);
+            published_us = now_us;
+        }
+        vTaskDelayUntil(&wake, period);
+    }
+}
+
+bool energyBegin(uint8_t battery_pin, uint32_t divider) {
+    if (running) return true;
+
+    bat_pin = battery_pin;
+    bat_divider = divider ? divider : 1;
+    i2cBusBegin();
+    has_shunt = probeShunt();
+    if (!has_shunt) Serial.println("⚠️  No INA226 at 0x40: time and voltage only");
+
+    if (!sampler &&
+        xTaskCreatePinnedToCore(samplerTask, "luca-energy", ENERGY_TASK_STACK, nullptr,
+                                ENERGY_TASK_PRIORITY, &sampler, ENERGY_TASK_CORE) != pdPASS) {
+        sampler = nullptr;
+        return false;
+    }
+
+    reset_pending = true;
+    running = true;
+    xTaskNotifyGive(sampler);
+    return true;
+}
+
+void energyEnd() {
+    running = false;
+}
+
+bool energyActive() {
+    return running;
+}
+
+void energyReset() {
+    reset_pending = true;
+}
+
+bool energyRead(EnergyReport& out) {
+    return report.tryRead(out);
+}
+
+const char* energyPhaseName(EnergyPhase phase) {
+    return phase_names[phase];
+}
+
+#if LUCA_ENERGY
+void energyTag(EnergyPhase phase, bool active) {
+    if (phase == ENERGY_IDLE) return;
+    if (active) active_phases.fetch_or(1 << phase, std::memory_order_relaxed);
+    else active_phases.fetch_and(~(1 << phase), std::memory_order_relaxed);
+}
+
+void energyCountPoll() {
+    polls.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
@@ -0,0 +1,78 @@
+/**
+ * LUCA T-Deck App - Energy profiling
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * While profiling is on, a sampler task reads the battery voltage (ADC)
+ * and the battery current (INA226 shunt monitor on the I2C bus, if one
+ * is fitted) every ENERGY_SAMPLE_MS and books the energy to the phase
+ * the firmware is in (luca_energy.h). Without a shunt monitor only time
+ * and voltage sag per phase are reported.
+ *
+ * Phases are tagged from the code that runs them. When several are
+ * active at once (a render while a fetch is in flight on the other
+ * core), the sample goes to the highest one in EnergyPhase order.
+ * Tagging is one atomic operation and also runs while profiling is off;
+ * build with -DLUCA_ENERGY=0 to compile it out.
+ *
+ * The sampler's own current is part of every phase. Compare builds with
+ * profiling on in both.
+ */
+
+#ifndef LUCA_ENERGY_PROFILE_H
+#define LUCA_ENERGY_PROFILE_H
+
+#include <stdint.h>
+#include <luca_energy.h>
+
+#ifndef LUCA_ENERGY
+#define LUCA_ENERGY 1
+#endif
+
+// In attribution order: later ones win when several are active
+enum EnergyPhase {
+    ENERGY_IDLE,        // Nothing tagged: waiting, light sleep
+    ENERGY_RENDER,      // uiRender(), without the last band draining
+    ENERGY_FETCH,       // One status poll on the networking task
+    ENERGY_WIFI,        // WiFi association in progress
+    ENERGY_PHASES
+};
+
+struct EnergyReport {
+    LucaEnergyMeter meter;
+    uint32_t polls;         // Status polls since the window started
+    bool current;           // false: no shunt monitor, energies are 0
+};
+
+// Start sampling with a fresh window. The ADC sees the cell through
+// divider. Safe to call again.
+bool energyBegin(uint8_t battery_pin, uint32_t divider);
+void energyEnd();
+bool energyActive();
+
+// Start a new window (the sampler picks it up within one sample)
+void energyReset();
+
+// Latest window, published by the sampler every ENERGY_PUBLISH_MS
+bool energyRead(EnergyReport& out);
+
+const char* energyPhaseName(EnergyPhase phase);
+
+#if LUCA_ENERGY
+void energyTag(EnergyPhase phase, bool active);
+void energyCountPoll();
+#else
+inline void energyTag(EnergyPhase, bool) {}
+inline void energyCountPoll() {}
+#endif
+
+// Tags the enclosing block
+class EnergyScope {
+public:
+    explicit EnergyScope(EnergyPhase phase) : phase_(phase) { energyTag(phase_, true); }
+    ~EnergyScope() { energyTag(phase_, false); }
+
+private:
+    EnergyPhase phase_;
+};
+
+#endif // LUCA_ENERGY_PROFILE_H
@@ -0,0 +1,243 @@
+/**
+ * LUCA T-Deck App - ESP-NOW gateway for nearby T5 units
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "gateway.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_idf_version.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <atomic>
+#include "seqlock.h"
+
+#define GATEWAY_TASK_CORE 0
+#define GATEWAY_TASK_STACK 4096
+#define GATEWAY_TASK_PRIORITY 2     // Above the networking task
+#define GATEWAY_QUEUE_DEPTH 4
+#define GATEWAY_PEERS 8             // Of ESP_NOW_MAX_TOTAL_PEER_NUM (20)
+
+struct GatewayPacket {
+    uint8_t mac[6];
+    uint8_t len;
+    uint8_t data[LUCA_ESPNOW_MAX];
+};
+
+struct GatewayStatus {
+    LucaStatusFrame frame;
+    uint32_t next_poll_ms;
+    bool valid;
+};
+
+// Last poll per T5: a repeated seq means our reply got lost, so the
+// messages are acknowledged again without being stored twice
+struct GatewayPeer {
+    uint8_t mac[6];
+    uint16_t seq;
+    uint8_t accepted;
+    uint32_t seen_ms;
+};
+
+static QueueHandle_t rx_queue = nullptr;
+static SeqLock<GatewayStatus> status_cache;
+static std::atomic<bool> running{false};
+static std::atomic<uint32_t> served{0};
+static std::atomic<uint8_t> peer_count{0};
+
+// Shared with the networking task, guarded by inbox_lock
+static SemaphoreHandle_t inbox_lock = nullptr;
+static GatewayMessage inbox[GATEWAY_INBOX];
+static size_t inbox_first = 0;
+static size_t inbox_count = 0;
+
+// Owned by the gateway task
+static GatewayPeer peers[GATEWAY_PEERS];
+
+// Runs on the WiFi task: copy and hand over, nothing else
+static void onReceive(const uint8_t* mac, const uint8_t* data, int len) {
+    if (len < LUCA_ESPNOW_HEADER_SIZE || len > LUCA_ESPNOW_MAX) return;
+
+    GatewayPacket packet;
+    memcpy(packet.mac, mac, sizeof(packet.mac));
+    packet.len = (uint8_t)len;
+    memcpy(packet.data, data, len);
+    xQueueSend(rx_queue, &packet, 0);   // Full: the T5 times out and uses WiFi
+}
+
+// Peer slot for mac, registering it with ESP-NOW (evicting the least
+// recently seen T5) if needed. nullptr if ESP-NOW refused it.
+static GatewayPeer* findPeer(const uint8_t* mac, bool& fresh) {
+    GatewayPeer* oldest = &peers[0];
+    for (GatewayPeer& peer : peers) {
+        if (peer.seen_ms != 0 && memcmp(peer.mac, mac, 6) == 0) {
+            fresh = false;
+            return &peer;
+        }
+        if (peer.seen_ms < oldest->seen_ms) oldest = &peer;
+    }
+
+    bool evict = oldest->seen_ms != 0;
+    if (evict) esp_now_del_peer(oldest->mac);
+    oldest->seen_ms = 0;
+
+    esp_now_peer_info_t info = {};
+    memcpy(info.peer_addr, mac, 6);
+    info.channel = 0;   // Whatever channel the STA is on
+    info.ifidx = WIFI_IF_STA;
+    info.encrypt = false;
+    if (esp_now_add_peer(&info) != ESP_OK) {
+        if (evict) peer_count--;
+        return nullptr;
+    }
+    if (!evict) peer_count++;
+
+    memcpy(oldest->mac, mac, 6);
+    fresh = true;
+    return oldest;
+}
+
+// Store the POLL's messages in order until the inbox is full; returns
+// how many were taken
+static uint8_t storeMessages(const GatewayPacket& packet, uint8_t count) {
+    uint8_t accepted = 0;
+    size_t offset = LUCA_ESPNOW_HEADER_SIZE;
+
+    xSemaphoreTake(inbox_lock, portMAX_DELAY);
+    while (accepted < count && inbox_count < GATEWAY_INBOX) {
+        GatewayMessage& msg = inbox[(inbox_first + inbox_count) % GATEWAY_INBOX];
+        offset = lucaEspNowNextMessage(packet.data, packet.len, offset, msg.text, msg.resonance);
+        if (offset == 0) break;
+        inbox_count++;
+        accepted++;
+    }
+    xSemaphoreGive(inbox_lock);
+    return accepted;
+}
+
+static void handlePoll(const GatewayPacket& packet) {
+    LucaEspNowHeader poll;
+    if (!lucaEspNowReadHeader(packet.data, packet.len, poll) || poll.type != LUCA_ESPNOW_POLL) return;
+
+    // Nothing from the backend yet: stay quiet so the T5 asks it directly
+    GatewayStatus status;
+    if (!status_cache.tryRead(status) || !status.valid) return;
+
+    bool fresh;
+    GatewayPeer* peer = findPeer(packet.mac, fresh);
+    if (!peer) return;
+
+    if (fresh || poll.seq != peer->seq) {
+        peer->seq = poll.seq;
+        peer->accepted = storeMessages(packet, poll.count);
+    }
+    peer->seen_ms = millis() | 1;   // 0 marks a free slot
+
+    bool unchanged = poll.value == status.frame.generation;
+    LucaEspNowHeader head = {
+        (uint8_t)(unchanged ? LUCA_ESPNOW_UNCHANGED : LUCA_ESPNOW_STATUS),
+        peer->accepted, poll.seq, status.next_poll_ms
+    };
+    uint8_t reply[LUCA_ESPNOW_REPLY_MAX];
+    size_t len = lucaEspNowWriteHeader(reply, head);
+    if (!unchanged) len += lucaFrameEncode(status.frame, reply + len, sizeof(reply) - len);
+
+    if (esp_now_send(packet.mac, reply, len) == ESP_OK) served++;
+}
+
+static void gatewayTask(void*) {
+    GatewayPacket packet;
+    for (;;) {
+        if (xQueueReceive(rx_queue, &packet, portMAX_DELAY) == pdTRUE && running) {
+            handlePoll(packet);
+        }
+    }
+}
+
+bool gatewayBegin() {
+    if (running) return true;
+
+    if (!rx_queue) {
+        rx_queue = xQueueCreate(GATEWAY_QUEUE_DEPTH, sizeof(GatewayPacket));
+        inbox_lock = xSemaphoreCreateMutex();
+        xTaskCreatePinnedToCore(gatewayTask, "luca-gateway", GATEWAY_TASK_STACK, nullptr,
+                                GATEWAY_TASK_PRIORITY, nullptr, GATEWAY_TASK_CORE);
+    }
+
+    if (esp_now_init() != ESP_OK) {
+        Serial.println("❌ ESP-NOW init failed, gateway off");
+        return false;
+    }
+#if ESP_IDF_VERSION_MAJOR >= 5
+    // Arduino core 3.x: the sender comes wrapped in esp_now_recv_info_t
+    esp_now_register_recv_cb([](const esp_now_recv_info_t* info, const uint8_t* data, int len) {
+        onReceive(info->src_addr, data, len);
+    });
+#else
+    esp_now_register_recv_cb(onReceive);
+#endif
+
+    // Modem sleep would drop polls arriving between beacons
+    WiFi.setSleep(false);
+    memset(peers, 0, sizeof(peers));
+    peer_count = 0;
+    running = true;
+    Serial.printf("✅ ESP-NOW gateway up on channel %d\n", WiFi.channel());
+    return true;
+}
+
+void gatewayEnd() {
+    if (!running) return;
+    running = false;
+    esp_now_unregister_recv_cb();
+    esp_now_deinit();
+    WiFi.setSleep(true);
+    peer_count = 0;
+    Serial.println("ESP-NOW gateway off");
+}
+
+bool gatewayActive() {
+    return running;
+}
+
+void gatewayShareStatus(const LUCAState& state, uint32_t next_poll_ms) {
+    GatewayStatus status = {lucaStatusToFrame(state), next_poll_ms, true};
+    status_cache.write(status);
+}
+
+void gatewayWithdrawStatus() {
+    GatewayStatus status = {};
+    status_cache.write(status);
+}
+
+size_t gatewayPeekMessages(GatewayMessage* out, size_t max) {
+    if (!inbox_lock) return 0;
+
+    xSemaphoreTake(inbox_lock, portMAX_DELAY);
+    size_t count = inbox_count < max ? inbox_count : max;
+    for (size_t i = 0; i < count; i++) out[i] = inbox[(inbox_first + i) % GATEWAY_INBOX];
+    xSemaphoreGive(inbox_lock);
+    return count;
+}
+
+void gatewayDropMessages(size_t count) {
+    if (!inbox_lock) return;
+
+    xSemaphoreTake(inbox_lock, portMAX_DELAY);
+    if (count > inbox_count) count = inbox_count;
+    inbox_first = (inbox_first + count) % GATEWAY_INBOX;
+    inbox_count -= count;
+    xSemaphoreGive(inbox_lock);
+}
+
+uint32_t gatewayServed() {
+    return served;
+}
+
+uint8_t gatewayPeerCount() {
+    return peer_count;
+}
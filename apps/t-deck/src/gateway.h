@@ -0,0 +1,59 @@
+/**
+ * LUCA T-Deck App - ESP-NOW gateway for nearby T5 units
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * In gateway mode the T-Deck answers T5 polls over ESP-NOW
+ * (luca_espnow.h) from a cached copy of the latest backend status, so a
+ * T5 wake is one packet each way instead of a WiFi association. Messages
+ * a T5 attaches are acknowledged once they sit in the inbox here; the
+ * networking task forwards them to the backend in batches. The backend
+ * sees one client however many T5 units are around.
+ *
+ * Replies are sent from a small task of their own, so an HTTP request in
+ * progress on the networking task never delays them. ESP-NOW shares the
+ * STA channel, so T5 units reach the gateway on the channel of their
+ * cached AP.
+ */
+
+#ifndef LUCA_GATEWAY_H
+#define LUCA_GATEWAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <luca_espnow.h>
+#include "luca_state.h"
+
+#define GATEWAY_INBOX 16    // T5 messages waiting for the batch POST
+
+struct GatewayMessage {
+    char text[LUCA_ESPNOW_TEXT_MAX + 1];
+    uint8_t resonance;
+};
+
+// Start answering T5 polls. WiFi must be started (STA mode); keeps the
+// radio out of modem sleep while running. Safe to call again.
+bool gatewayBegin();
+
+void gatewayEnd();
+
+bool gatewayActive();
+
+// Latest backend status and the hint T5 units get for their next poll.
+// Networking task only.
+void gatewayShareStatus(const LUCAState& state, uint32_t next_poll_ms);
+
+// Stop serving status until the next gatewayShareStatus(); T5 units then
+// get no reply and fall back to their own WiFi
+void gatewayWithdrawStatus();
+
+// Copy up to max of the oldest inbox messages without removing them
+size_t gatewayPeekMessages(GatewayMessage* out, size_t max);
+
+// Remove the count oldest messages once the backend has taken them
+void gatewayDropMessages(size_t count);
+
+// Polls answered since boot, and T5 units currently registered as peers
+uint32_t gatewayServed();
+uint8_t gatewayPeerCount();
+
+#endif // LUCA_GATEWAY_H
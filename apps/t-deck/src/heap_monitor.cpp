@@ -0,0 +1,60 @@
+/**
+ * LUCA T-Deck App - Heap and stack health
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "heap_monitor.h"
+#include <Arduino.h>
+#include <atomic>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define HEAP_INTERNAL (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+
+// Tasks started by the app and the Arduino core; missing ones (e.g. the
+// energy sampler while profiling is off) are left out of the report
+static const char* const task_names[] = {
+    "loopTask", "luca-net", "luca-lora", "luca-keys", "luca-gateway", "luca-energy",
+};
+
+static_assert(sizeof(task_names) / sizeof(task_names[0]) <= HEAP_TASKS_MAX, "report holds every task");
+
+static uint32_t baseline = 0;
+static std::atomic<uint32_t> failed_allocs{0};
+
+// May run in any task, with the heap lock released; only counts
+static void onAllocFailed(size_t, uint32_t, const char*) {
+    failed_allocs.fetch_add(1);
+}
+
+void heapMonitorBegin() {
+    heap_caps_register_failed_alloc_callback(onAllocFailed);
+    heapMonitorReset();
+}
+
+void heapMonitorReset() {
+    baseline = heap_caps_get_free_size(HEAP_INTERNAL);
+}
+
+HeapReport heapReport() {
+    HeapReport report = {};
+    report.free_bytes = heap_caps_get_free_size(HEAP_INTERNAL);
+    report.largest_block = heap_caps_get_largest_free_block(HEAP_INTERNAL);
+    report.min_free_bytes = heap_caps_get_minimum_free_size(HEAP_INTERNAL);
+    report.baseline_delta = (int32_t)(report.free_bytes - baseline);
+    report.failed_allocs = failed_allocs.load();
+    report.psram_total = heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
+    report.psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    report.psram_largest_block = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+
+    for (const char* name : task_names) {
+        TaskHandle_t task = xTaskGetHandle(name);
+        if (!task) continue;
+        // ESP-IDF counts stacks in bytes, not words
+        HeapTaskStack& entry = report.tasks[report.task_count++];
+        entry.name = name;
+        entry.unused_bytes = uxTaskGetStackHighWaterMark(task);
+    }
+    return report;
+}
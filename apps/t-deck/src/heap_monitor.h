@@ -0,0 +1,47 @@
+/**
+ * LUCA T-Deck App - Heap and stack health
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Steady state should not allocate: buffers are static or sized once at
+ * boot. This reports what would show it doing so over weeks of uptime -
+ * free internal heap against a baseline taken after setup(), the largest
+ * free block (fragmentation shrinks it while free stays level), the
+ * low-water mark, failed allocations, PSRAM use and the unused stack of
+ * every LUCA task.
+ */
+
+#ifndef LUCA_HEAP_MONITOR_H
+#define LUCA_HEAP_MONITOR_H
+
+#include <stdint.h>
+
+#define HEAP_TASKS_MAX 8
+
+struct HeapTaskStack {
+    const char* name;
+    uint32_t unused_bytes;      // Stack high-water mark: never touched so far
+};
+
+struct HeapReport {
+    uint32_t free_bytes;        // Internal RAM
+    uint32_t largest_block;
+    uint32_t min_free_bytes;    // Since boot
+    int32_t baseline_delta;     // free_bytes - free at the baseline
+    uint32_t failed_allocs;
+    uint32_t psram_total;       // 0 without PSRAM
+    uint32_t psram_free;
+    uint32_t psram_largest_block;
+    uint8_t task_count;
+    HeapTaskStack tasks[HEAP_TASKS_MAX];
+};
+
+// Take the baseline and start counting failed allocations; call at the
+// end of setup(), once every task and buffer exists
+void heapMonitorBegin();
+
+// New baseline, e.g. after a configuration change
+void heapMonitorReset();
+
+HeapReport heapReport();
+
+#endif // LUCA_HEAP_MONITOR_H
@@ -0,0 +1,220 @@
+/**
+ * LUCA T-Deck App - Status history
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "history.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <atomic>
+#include <luca_status_frame.h>
+
+#define HISTORY_BLOCKS (HISTORY_CAPACITY / HISTORY_BLOCK)
+#define DELTA_UNIT_MS 100           // Deltas saturate at ~1.8 h
+
+static_assert(HISTORY_CAPACITY % HISTORY_BLOCK == 0, "blocks must tile the ring");
+
+struct HistoryBlock {
+    uint16_t min[HIST_METRICS];
+    uint16_t max[HIST_METRICS];
+};
+
+// PSRAM, struct of arrays: 4 x 2 bytes per sample, ~135 KB
+static uint16_t* samples[HIST_METRICS] = {nullptr, nullptr, nullptr};
+static uint16_t* deltas = nullptr;
+
+// Internal RAM, small enough to scan on every query
+static HistoryBlock blocks[HISTORY_BLOCKS];
+static uint32_t sums[HIST_METRICS];
+static uint32_t head = 0;           // Next slot to write
+static uint32_t count = 0;
+static uint32_t total = 0;
+static uint32_t epoch = 0;        // total when a full sync last emptied the ring
+static unsigned long newest_ms = 0;
+static std::atomic<uint32_t> newest_generation{0};
+
+// Sync in progress: the values in effect since sync_from_ms
+static bool syncing = false;
+static bool sync_have_values = false;
+static uint16_t sync_values[HIST_METRICS];
+static unsigned long sync_from_ms = 0;
+
+bool historyBegin() {
+    if (!LucaBoard::psram) return false;    // 24 h of samples do not fit in internal RAM
+
+    for (int m = 0; m < HIST_METRICS; m++) {
+        samples[m] = (uint16_t*)heap_caps_malloc(HISTORY_CAPACITY * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    }
+    deltas = (uint16_t*)heap_caps_malloc(HISTORY_CAPACITY * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+
+    if (!samples[0] || !samples[1] || !samples[2] || !deltas) {
+        for (int m = 0; m < HIST_METRICS; m++) {
+            heap_caps_free(samples[m]);
+            samples[m] = nullptr;
+        }
+        heap_caps_free(deltas);
+        deltas = nullptr;
+        return false;
+    }
+    return true;
+}
+
+static void appendValues(const uint16_t values[HIST_METRICS], unsigned long now_ms) {
+    HistoryBlock& block = blocks[head / HISTORY_BLOCK];
+    bool block_start = head % HISTORY_BLOCK == 0;
+
+    for (int m = 0; m < HIST_METRICS; m++) {
+        // The running sum drops the sample being overwritten
+        if (count == HISTORY_CAPACITY) sums[m] -= samples[m][head];
+        samples[m][head] = values[m];
+        sums[m] += values[m];
+
+        if (block_start) {
+            block.min[m] = block.max[m] = values[m];
+        } else {
+            if (values[m] < block.min[m]) block.min[m] = values[m];
+            if (values[m] > block.max[m]) block.max[m] = values[m];
+        }
+    }
+
+    unsigned long delta = count == 0 ? 0 : (now_ms - newest_ms) / DELTA_UNIT_MS;
+    deltas[head] = (uint16_t)min(delta, 0xFFFFUL);
+    newest_ms = now_ms;
+
+    head = (head + 1) % HISTORY_CAPACITY;
+    if (count < HISTORY_CAPACITY) count++;
+    total++;
+}
+
+void historyAppend(const LUCAState& state, unsigned long now_ms) {
+    if (!deltas) return;
+
+    const uint16_t values[HIST_METRICS] = {
+        lucaToQ16(state.consciousness_level),
+        lucaToQ16(state.quantum_coherence),
+        lucaToQ16(state.akashic_connection),
+    };
+    appendValues(values, now_ms);
+    newest_generation.store(state.generation);
+}
+
+// Grid points from after the newest sample (or from_ms in an empty ring)
+// up to, not including, until_ms. Only the last HISTORY_CAPACITY of
+// them can be held, so earlier ones are skipped.
+static void fillUntil(unsigned long until_ms, uint32_t& budget) {
+    unsigned long at = count ? newest_ms + HISTORY_SAMPLE_MS : sync_from_ms;
+    const long span = (long)HISTORY_CAPACITY * HISTORY_SAMPLE_MS;
+    if ((long)(until_ms - at) > span) at = until_ms - span;
+    while (budget > 0 && (long)(until_ms - at) > 0) {
+        appendValues(sync_values, at);
+        at += HISTORY_SAMPLE_MS;
+        budget--;
+    }
+}
+
+bool historySyncStep(const HistorySyncStep& step, uint32_t& budget) {
+    if (!deltas) return true;
+
+    switch (step.kind) {
+        case HISTORY_SYNC_BEGIN:
+            if (step.full) {
+                head = count = 0;       // total keeps counting, see historyEpoch()
+                epoch = total;
+                memset(sums, 0, sizeof(sums));
+            }
+            // A gap sync starts from what the device showed last
+            sync_have_values = count > 0;
+            for (int m = 0; m < HIST_METRICS && sync_have_values; m++) {
+                sync_values[m] = historySample((HistoryMetric)m, 0);
+            }
+            newest_generation.store(step.generation);
+            syncing = true;
+            return true;
+
+        case HISTORY_SYNC_RECORD:
+        case HISTORY_SYNC_END:
+            if (!syncing) return true;
+            if (sync_have_values) {
+                fillUntil(step.at_ms, budget);
+                if (budget == 0 && (long)(step.at_ms - (newest_ms + HISTORY_SAMPLE_MS)) > 0) return false;
+            }
+            if (step.kind == HISTORY_SYNC_END) {
+                newest_generation.store(step.generation);
+                syncing = false;
+            } else {
+                memcpy(sync_values, step.values, sizeof(sync_values));
+                sync_from_ms = step.at_ms;
+                sync_have_values = true;
+            }
+            return true;
+    }
+    return true;
+}
+
+bool historySyncing() {
+    return syncing;
+}
+
+uint32_t historyCount() {
+    return count;
+}
+
+uint32_t historyTotal() {
+    return total;
+}
+
+uint32_t historyGeneration() {
+    return newest_generation.load();
+}
+
+uint32_t historyEpoch() {
+    return epoch;
+}
+
+static uint32_t slotOf(uint32_t age) {
+    return (head + HISTORY_CAPACITY - 1 - age) % HISTORY_CAPACITY;
+}
+
+uint16_t historySample(HistoryMetric metric, uint32_t age) {
+    return samples[metric][slotOf(age)];
+}
+
+unsigned long historyAgeMs(uint32_t age) {
+    unsigned long ms = 0;
+    for (uint32_t i = 0; i < age; i++) {
+        ms += deltas[slotOf(i)] * DELTA_UNIT_MS;
+    }
+    return ms;
+}
+
+HistoryStats historyStats(HistoryMetric metric) {
+    HistoryStats stats = {0.0f, 0.0f, 0.0f, count};
+    if (count == 0) return stats;
+
+    // Blocks past the write position only hold data once the ring has wrapped
+    uint32_t used = count == HISTORY_CAPACITY ? HISTORY_BLOCKS : (count + HISTORY_BLOCK - 1) / HISTORY_BLOCK;
+    uint16_t lo = 0xFFFF, hi = 0;
+    for (uint32_t b = 0; b < used; b++) {
+        if (blocks[b].min[metric] < lo) lo = blocks[b].min[metric];
+        if (blocks[b].max[metric] > hi) hi = blocks[b].max[metric];
+    }
+
+    stats.min = lo / 65535.0f;
+    stats.max = hi / 65535.0f;
+    stats.mean = (float)sums[metric] / count / 65535.0f;
+    return stats;
+}
+
+LucaMoments historyMoments(HistoryMetric metric, uint32_t window) {
+    LucaMoments moments = {0, 0, 0};
+    uint32_t n = window < count ? window : count;
+
+    // The newest n end just before head, in two spans if they cross slot 0
+    if (n <= head) {
+        lucaMomentsScan(moments, samples[metric] + head - n, n);
+    } else {
+        lucaMomentsScan(moments, samples[metric] + HISTORY_CAPACITY - (n - head), n - head);
+        lucaMomentsScan(moments, samples[metric], head);
+    }
+    return moments;
+}
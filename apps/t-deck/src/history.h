@@ -0,0 +1,103 @@
+/**
+ * LUCA T-Deck App - Status history
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * 24 hours of consciousness / coherence / akashic samples at a 5 s
+ * cadence, kept in PSRAM as one array per metric (Q0.16) plus one array
+ * of timestamp deltas. Min/max/mean over the window are maintained as
+ * samples come in, so queries never walk the whole buffer.
+ *
+ * After boot or a time offline the backend's record of the status fills
+ * the ring (historySync*): the networking task streams /api/t5/history
+ * into HistorySyncStep records, the UI loop lays them out as samples a
+ * bounded number at a time.
+ *
+ * Owned by the UI loop: append and read from the same task.
+ */
+
+#ifndef LUCA_HISTORY_H
+#define LUCA_HISTORY_H
+
+#include <stdint.h>
+#include <luca_metrics.h>
+#include "luca_state.h"
+
+#define HISTORY_SAMPLE_MS 5000
+#define HISTORY_CAPACITY 17280      // 24 h at 5 s
+#define HISTORY_BLOCK 144           // Samples per min/max block (12 min)
+#define HISTORY_WINDOW 720          // 1 h, what the on-device metrics look back over
+#define HISTORY_SYNC_SLICE 1440     // Samples laid out per historySyncStep() budget (2 h)
+
+// Same order as the UI bars
+enum HistoryMetric {
+    HIST_CONSCIOUSNESS,
+    HIST_COHERENCE,
+    HIST_AKASHIC,
+    HIST_METRICS
+};
+
+enum HistorySyncKind : uint8_t {
+    HISTORY_SYNC_BEGIN,     // full: replace the ring, else continue after the newest sample
+    HISTORY_SYNC_RECORD,    // values hold from at_ms until the next step
+    HISTORY_SYNC_END        // the last values hold until at_ms (the response time)
+};
+
+struct HistorySyncStep {
+    HistorySyncKind kind;
+    bool full;
+    unsigned long at_ms;    // millis() time base; may lie before boot (wraps)
+    uint32_t generation;    // BEGIN: asked since, RECORD: of the change, END: newest received
+    uint16_t values[HIST_METRICS];
+};
+
+struct HistoryStats {
+    float min;
+    float max;
+    float mean;
+    uint32_t count;
+};
+
+// Allocate the buffer in PSRAM. Returns false (history stays empty) without it.
+bool historyBegin();
+
+// Record one sample taken at now_ms
+void historyAppend(const LUCAState& state, unsigned long now_ms);
+
+// Samples currently held (at most HISTORY_CAPACITY)
+uint32_t historyCount();
+
+// Samples appended since boot; never wraps in practice, identifies the newest
+uint32_t historyTotal();
+
+// Generation of the newest status in the ring: the last live sample or
+// what a sync wrote. Safe to read from the networking task; a gap sync
+// asks for the changes after it.
+uint32_t historyGeneration();
+
+// historyTotal() when a full sync last emptied the ring (0 until then).
+// Samples drawn before it are gone, not just scrolled out.
+uint32_t historyEpoch();
+
+// Q0.16 value of the sample `age` steps back (0 = newest). age < historyCount().
+uint16_t historySample(HistoryMetric metric, uint32_t age);
+
+// How long before the newest sample the sample `age` steps back was taken
+unsigned long historyAgeMs(uint32_t age);
+
+// Min and max cover the window except, right after a wrap, up to one
+// block of the oldest samples; the mean is exact.
+HistoryStats historyStats(HistoryMetric metric);
+
+// Apply one sync step, appending at most `budget` samples on the
+// HISTORY_SAMPLE_MS grid after the newest one (budget is decreased).
+// Returns false if the budget ran out first; pass the same step again.
+bool historySyncStep(const HistorySyncStep& step, uint32_t& budget);
+
+// Between a BEGIN and its END step; live appends would break time order
+bool historySyncing();
+
+// Moments of the newest `window` samples (fewer if not held yet), for
+// the on-device metrics (luca_metrics.h). Reads them from PSRAM.
+LucaMoments historyMoments(HistoryMetric metric, uint32_t window);
+
+#endif // LUCA_HISTORY_H
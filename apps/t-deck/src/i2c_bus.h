@@ -0,0 +1,24 @@
+/**
+ * LUCA T-Deck App - Shared I2C bus
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Keyboard controller (0x55), touch and the optional INA226 (0x40) share
+ * one bus. Wire serialises access between tasks itself; whoever needs the
+ * bus first starts it.
+ */
+
+#ifndef LUCA_I2C_BUS_H
+#define LUCA_I2C_BUS_H
+
+#include <Wire.h>
+
+#define I2C_SDA 18
+#define I2C_SCL 8
+#define I2C_CLOCK_HZ 400000
+
+// Safe to call again; later calls leave the running bus alone
+inline bool i2cBusBegin() {
+    return Wire.begin(I2C_SDA, I2C_SCL, I2C_CLOCK_HZ);
+}
+
+#endif // LUCA_I2C_BUS_H
@@ -0,0 +1,293 @@
+/**
+ * LUCA T-Deck App - Minimal keep-alive HTTP/1.1 client
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "keepalive_http.h"
+
+#define HTTP_LINE_MAX 128
+#define HTTP_REQUEST_MAX 384
+
+bool parseHttpTarget(const char* url, HttpTarget& out) {
+    static const char plain[] = "http://";
+    static const char secure[] = "https://";
+    const char* p;
+    if (strncmp(url, plain, sizeof(plain) - 1) == 0) {
+        p = url + sizeof(plain) - 1;
+        out.tls = false;
+    } else if (strncmp(url, secure, sizeof(secure) - 1) == 0) {
+        p = url + sizeof(secure) - 1;
+        out.tls = true;
+    } else {
+        return false;
+    }
+
+    size_t host_len = strcspn(p, ":/");
+    if (host_len == 0 || host_len > HTTP_HOST_MAX) return false;
+    memcpy(out.host, p, host_len);
+    out.host[host_len] = '\0';
+    p += host_len;
+
+    out.port = out.tls ? 443 : 80;
+    if (*p == ':') {
+        char* end;
+        long port = strtol(p + 1, &end, 10);
+        if (end == p + 1 || port <= 0 || port > 65535) return false;
+        out.port = (uint16_t)port;
+        p = end;
+    }
+
+    // Remaining path is a prefix for every request; drop a trailing slash
+    size_t path_len = strlen(p);
+    if (path_len > 0 && p[path_len - 1] == '/') path_len--;
+    if (path_len > HTTP_PATH_MAX) return false;
+    memcpy(out.path_prefix, p, path_len);
+    out.path_prefix[path_len] = '\0';
+    return true;
+}
+
+// One CRLF terminated line; over-long lines are truncated, not fatal
+static bool readLine(Client& client, char* line, size_t size, unsigned long deadline) {
+    size_t len = 0;
+    while ((long)(deadline - millis()) > 0) {
+        int c = client.read();
+        if (c < 0) {
+            if (!client.connected()) return false;
+            delay(1);
+            continue;
+        }
+        if (c == '\n') {
+            if (len > 0 && line[len - 1] == '\r') len--;
+            line[len] = '\0';
+            return true;
+        }
+        if (len < size - 1) line[len++] = (char)c;
+    }
+    return false;
+}
+
+// Read the next chunk-size line (after the CRLF that ends the previous
+// chunk). The last chunk and its trailers end the body.
+bool HttpBody::nextChunk() {
+    char line[HTTP_LINE_MAX];
+    unsigned long deadline = millis() + HTTP_TIMEOUT_MS;
+    do {
+        if (!readLine(*client_, line, sizeof(line), deadline)) {
+            client_->stop();    // Framing lost, the connection cannot be reused
+            remaining_ = 0;
+            return false;
+        }
+    } while (line[0] == '\0');
+
+    char* end;
+    unsigned long size = strtoul(line, &end, 16);
+    if (end == line) {
+        client_->stop();
+        remaining_ = 0;
+        return false;
+    }
+    if (size == 0) {
+        while (readLine(*client_, line, sizeof(line), deadline) && line[0] != '\0') {}
+        remaining_ = 0;
+        return false;
+    }
+    chunk_left_ = size;
+    return true;
+}
+
+int HttpBody::available() {
+    if (!client_ || remaining_ == 0) return 0;
+    int n = client_->available();
+    if (chunked_) {
+        if (n > 0 && chunk_left_ == 0 && !nextChunk()) return 0;
+        n = client_->available();
+        return (size_t)n < chunk_left_ ? n : (int)chunk_left_;
+    }
+    return (size_t)n < remaining_ ? n : (int)remaining_;
+}
+
+int HttpBody::read() {
+    if (!client_ || remaining_ == 0) return -1;
+    if (chunked_ && chunk_left_ == 0 && !nextChunk()) return -1;
+    int c = client_->read();
+    if (c >= 0) {
+        if (chunked_) {
+            chunk_left_--;
+        } else {
+            remaining_--;
+        }
+    }
+    return c;
+}
+
+int HttpBody::peek() {
+    if (!client_ || remaining_ == 0) return -1;
+    if (chunked_ && chunk_left_ == 0 && !nextChunk()) return -1;
+    return client_->peek();
+}
+
+int HttpBody::peekWait() {
+    unsigned long start = millis();
+    while (client_ && remaining_ > 0) {
+        int c = peek();
+        if (c >= 0) return c;
+        if (!client_->connected() || millis() - start >= getTimeout()) break;
+        delay(1);
+    }
+    return -1;
+}
+
+void KeepAliveHttp::setTarget(const HttpTarget& target) {
+    if (strcmp(target.host, target_.host) != 0 || target.port != target_.port ||
+        target.tls != target_.tls) {
+        close();
+    }
+    target_ = target;
+    client_ = target_.tls ? &tls_ : &tcp_;
+}
+
+void KeepAliveHttp::setPin(const uint8_t* pin) {
+    close();
+    session_.len = 0;   // Established under the old pin
+    if (pin) {
+        tls_.setPin(pin);
+    } else {
+        tls_.clearPin();
+    }
+}
+
+bool KeepAliveHttp::ensureConnected() {
+    if (client_->connected()) return true;
+    if (target_.host[0] == '\0') return false;
+
+    if (!client_->connect(target_.host, target_.port)) return false;
+    client_->setNoDelay(true);
+    return true;
+}
+
+int KeepAliveHttp::get(const char* path, const char* extra_headers) {
+    return request("GET", path, extra_headers, nullptr, 0);
+}
+
+int KeepAliveHttp::post(const char* path, const char* content_type, const char* body, size_t len) {
+    char headers[HTTP_LINE_MAX];
+    int headers_len = snprintf(headers, sizeof(headers),
+                               "Content-Type: %s\r\nContent-Length: %u\r\n",
+                               content_type, (unsigned)len);
+    if (headers_len <= 0 || headers_len >= (int)sizeof(headers)) return -1;
+    return request("POST", path, headers, (const uint8_t*)body, len);
+}
+
+int KeepAliveHttp::request(const char* method, const char* path, const char* extra_headers,
+                           const uint8_t* body, size_t body_len) {
+    finish();
+
+    char request[HTTP_REQUEST_MAX];
+    int request_len = snprintf(request, sizeof(request),
+                               "%s %s%s HTTP/1.1\r\n"
+                               "Host: %s:%u\r\n"
+                               "Connection: keep-alive\r\n"
+                               "%s\r\n",
+                               method, target_.path_prefix, path, target_.host, target_.port,
+                               extra_headers ? extra_headers : "");
+    if (request_len <= 0 || request_len >= (int)sizeof(request)) return -1;
+
+    // The server may have dropped an idle keep-alive socket since the last
+    // poll; that only shows up on use, so retry once on a fresh connection.
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = client_->connected();
+        if (!ensureConnected()) return -1;
+
+        char line[HTTP_LINE_MAX];
+        unsigned long deadline = millis() + HTTP_TIMEOUT_MS;
+        if (client_->write((const uint8_t*)request, request_len) != (size_t)request_len ||
+            (body_len > 0 && client_->write(body, body_len) != body_len) ||
+            !readLine(*client_, line, sizeof(line), deadline)) {
+            close();
+            if (reused) continue;
+            return -1;
+        }
+
+        // Status line: HTTP/1.x NNN reason
+        if (strncmp(line, "HTTP/1.", 7) != 0 || strlen(line) < 12) {
+            close();
+            return -1;
+        }
+        int status = atoi(line + 9);
+        keep_alive_ = line[7] == '1';
+
+        long content_length = -1;
+        bool chunked = false;
+        next_poll_hint_ = 0;
+        etag_[0] = '\0';
+        for (;;) {
+            if (!readLine(*client_, line, sizeof(line), deadline)) {
+                close();
+                return -1;
+            }
+            if (line[0] == '\0') break;
+
+            if (strncasecmp(line, "Content-Length:", 15) == 0) {
+                content_length = strtol(line + 15, nullptr, 10);
+            } else if (strncasecmp(line, "ETag:", 5) == 0) {
+                const char* value = line + 5;
+                while (*value == ' ') value++;
+                strlcpy(etag_, value, sizeof(etag_));
+            } else if (strncasecmp(line, "X-Next-Poll-Ms:", 15) == 0) {
+                next_poll_hint_ = strtoul(line + 15, nullptr, 10);
+            } else if (strncasecmp(line, "Connection:", 11) == 0) {
+                keep_alive_ = strcasestr(line + 11, "close") == nullptr;
+            } else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0) {
+                // chunked is the only coding a server may apply here
+                if (strcasestr(line + 18, "chunked") == nullptr) {
+                    close();
+                    return -1;
+                }
+                chunked = true;
+            }
+        }
+
+        body_.client_ = client_;
+        body_.setTimeout(HTTP_TIMEOUT_MS);
+        body_.chunked_ = false;
+        body_.chunk_left_ = 0;
+        if (status == 204 || status == 304) {
+            body_.remaining_ = 0;
+        } else if (chunked) {
+            // Ends with the last chunk, not with the socket
+            body_.chunked_ = true;
+            body_.remaining_ = SIZE_MAX;
+        } else if (content_length >= 0) {
+            body_.remaining_ = (size_t)content_length;
+        } else {
+            // Body runs until the server closes the socket
+            body_.remaining_ = SIZE_MAX;
+            keep_alive_ = false;
+        }
+        return status;
+    }
+    return -1;
+}
+
+void KeepAliveHttp::finish() {
+    if (body_.client_ && !keep_alive_) {
+        close();
+        return;
+    }
+
+    unsigned long deadline = millis() + HTTP_TIMEOUT_MS;
+    while (body_.remaining_ > 0) {
+        if ((long)(deadline - millis()) <= 0 || !client_->connected()) {
+            close();
+            return;
+        }
+        if (body_.read() < 0) delay(1);
+    }
+}
+
+void KeepAliveHttp::close() {
+    client_->stop();
+    body_.client_ = nullptr;
+    body_.remaining_ = 0;
+    keep_alive_ = false;
+}
@@ -0,0 +1,115 @@
+/**
+ * LUCA T-Deck App - Minimal keep-alive HTTP/1.1 client
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * One TCP connection to the backend is opened on demand and reused for
+ * every poll. Response heads are parsed byte by byte into a fixed line
+ * buffer and the body is handed out as a Stream bounded by
+ * Content-Length, or decoded from chunked transfer encoding, so callers
+ * can deserialize straight from the socket.
+ * Nothing here allocates on the heap except mbedTLS, for the record
+ * buffers of an https:// connection (luca_tls.h). The TLS session is
+ * kept across reconnects, so only the first connection does the full
+ * handshake.
+ */
+
+#ifndef LUCA_KEEPALIVE_HTTP_H
+#define LUCA_KEEPALIVE_HTTP_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <luca_tls.h>
+
+#define HTTP_HOST_MAX 63
+#define HTTP_PATH_MAX 63
+#define HTTP_TIMEOUT_MS 2000
+#define HTTP_ETAG_MAX 47
+
+// Parsed form of an api_url like http://192.168.1.100:8000/prefix
+struct HttpTarget {
+    char host[HTTP_HOST_MAX + 1];
+    uint16_t port;
+    char path_prefix[HTTP_PATH_MAX + 1];
+    bool tls;       // https://
+};
+
+// Returns false for anything but an http:// or https:// URL
+bool parseHttpTarget(const char* url, HttpTarget& out);
+
+// Response body limited to Content-Length bytes of the underlying client,
+// or the data of its chunks without the chunk framing
+class HttpBody : public Stream {
+public:
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t) override { return 0; }
+
+    // peek() that waits up to the stream timeout for the first byte
+    int peekWait();
+
+    // Bytes left; SIZE_MAX while a chunked or close-delimited body runs
+    size_t remaining() const { return remaining_; }
+
+private:
+    friend class KeepAliveHttp;
+    bool nextChunk();
+
+    Client* client_ = nullptr;
+    size_t remaining_ = 0;
+    bool chunked_ = false;
+    size_t chunk_left_ = 0;     // Data bytes left in the current chunk
+};
+
+class KeepAliveHttp {
+public:
+    KeepAliveHttp() { tls_.setSession(&session_); }
+
+    // Point at a new backend; drops the current connection if it changed
+    void setTarget(const HttpTarget& target);
+
+    // Server key for https:// targets (luca_tls.h); nullptr clears it.
+    // Without a pin https:// requests fail.
+    void setPin(const uint8_t* pin);
+
+    // Send a GET for path_prefix + path and read the response head.
+    // Returns the HTTP status code, or -1 on a connection/protocol error.
+    // extra_headers, if given, must be complete "Name: value\r\n" lines.
+    int get(const char* path, const char* extra_headers = nullptr);
+
+    // Same for a POST with a Content-Length framed body
+    int post(const char* path, const char* content_type, const char* body, size_t len);
+
+    // Body of the last response (valid until the next get() or post())
+    HttpBody& body() { return body_; }
+
+    // X-Next-Poll-Ms of the last response, 0 if it had none
+    uint32_t nextPollHint() const { return next_poll_hint_; }
+
+    // ETag of the last response as sent (quotes included), "" if none
+    const char* etag() const { return etag_; }
+
+    // Skip whatever is left of the body so the connection can be reused
+    void finish();
+
+    void close();
+
+    bool connected() { return client_->connected(); }
+
+private:
+    int request(const char* method, const char* path, const char* extra_headers,
+                const uint8_t* body, size_t body_len);
+    bool ensureConnected();
+
+    WiFiClient tcp_;
+    LucaTlsClient tls_;
+    LucaTlsSession session_ = {};
+    WiFiClient* client_ = &tcp_;    // tcp_ or tls_, after target_.tls
+    HttpTarget target_ = {};
+    bool keep_alive_ = false;
+    uint32_t next_poll_hint_ = 0;
+    char etag_[HTTP_ETAG_MAX + 1] = "";
+    HttpBody body_;
+};
+
+#endif // LUCA_KEEPALIVE_HTTP_H
@@ -0,0 +1,82 @@
+/**
+ * LUCA T-Deck App - Built-in keyboard
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "keyboard.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <atomic>
+#include "i2c_bus.h"
+
+#define KEYBOARD_TASK_CORE 1        // Next to the UI loop it feeds
+#define KEYBOARD_TASK_STACK 2048
+#define KEYBOARD_TASK_PRIORITY 3    // Above loop(), so a key preempts a frame
+#define KEYBOARD_DRAIN_MAX 8        // Reads per wake-up, in case the line sticks
+
+static TaskHandle_t reader = nullptr;
+static QueueHandle_t keys = nullptr;
+static KeyboardHook key_hook = nullptr;
+static std::atomic<uint32_t> irq_us{0};
+static bool irq_seen = false;       // Reader task only
+
+static void IRAM_ATTR onKeyboardIrq() {
+    irq_us.store((uint32_t)esp_timer_get_time(), std::memory_order_relaxed);
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(reader, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+static char readKey() {
+    if (Wire.requestFrom(KEYBOARD_ADDR, 1) != 1) return 0;
+    return (char)Wire.read();
+}
+
+static void readerTask(void*) {
+    for (;;) {
+        bool irq = ulTaskNotifyTake(pdTRUE, irq_seen ? portMAX_DELAY : pdMS_TO_TICKS(KEYBOARD_POLL_MS)) > 0;
+        if (irq) irq_seen = true;
+        uint32_t at_us = irq ? irq_us.load(std::memory_order_relaxed) : (uint32_t)esp_timer_get_time();
+
+        bool queued = false;
+        for (int i = 0; i < KEYBOARD_DRAIN_MAX; i++) {
+            char key = readKey();
+            if (key == 0) break;
+            KeyEvent event = {key, at_us};
+            queued |= xQueueSend(keys, &event, 0) == pdTRUE;   // Full: the UI is stuck, drop
+        }
+        if (queued && key_hook) key_hook();
+    }
+}
+
+bool keyboardBegin(KeyboardHook on_key) {
+    if (reader) return true;
+
+    i2cBusBegin();
+    Wire.beginTransmission(KEYBOARD_ADDR);
+    if (Wire.endTransmission() != 0) {
+        Serial.println("⚠️  No keyboard at 0x55");
+        return false;
+    }
+
+    key_hook = on_key;
+    keys = xQueueCreate(KEYBOARD_QUEUE_DEPTH, sizeof(KeyEvent));
+    if (!keys ||
+        xTaskCreatePinnedToCore(readerTask, "luca-keys", KEYBOARD_TASK_STACK, nullptr,
+                                KEYBOARD_TASK_PRIORITY, &reader, KEYBOARD_TASK_CORE) != pdPASS) {
+        reader = nullptr;
+        return false;
+    }
+
+    pinMode(KEYBOARD_INT_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(KEYBOARD_INT_PIN), onKeyboardIrq, FALLING);
+    Serial.println("✅ Keyboard ready");
+    return true;
+}
+
+bool keyboardRead(KeyEvent& out) {
+    return keys && xQueueReceive(keys, &out, 0) == pdTRUE;
+}
@@ -0,0 +1,44 @@
+/**
+ * LUCA T-Deck App - Built-in keyboard
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * The keyboard is an ESP32-C3 on the I2C bus at 0x55: each one-byte read
+ * returns the next pending key, 0 when there is none. It pulls its
+ * interrupt line low on a keypress. The line's ISR wakes a reader task on
+ * the UI core that drains the controller and queues the keys, stamped
+ * with the interrupt time so the UI can measure key-to-pixel latency.
+ *
+ * Keyboard firmware that never pulses the line still works: until the
+ * first interrupt the reader also polls every KEYBOARD_POLL_MS.
+ */
+
+#ifndef LUCA_KEYBOARD_H
+#define LUCA_KEYBOARD_H
+
+#include <stdint.h>
+
+#define KEYBOARD_ADDR 0x55
+#define KEYBOARD_INT_PIN 46
+#define KEYBOARD_QUEUE_DEPTH 32
+#define KEYBOARD_POLL_MS 50
+
+// Control keys as the controller sends them; everything else is ASCII
+#define KEY_ENTER 0x0D
+#define KEY_BACKSPACE 0x08
+
+struct KeyEvent {
+    char key;
+    uint32_t at_us;         // esp_timer time of the interrupt (or poll), wraps; use differences
+};
+
+// Called on the reader task after keys were queued
+typedef void (*KeyboardHook)();
+
+// Probe the controller and start the reader task. Returns false (and
+// stays off) if nothing answers at KEYBOARD_ADDR.
+bool keyboardBegin(KeyboardHook on_key = nullptr);
+
+// Next queued key, without waiting
+bool keyboardRead(KeyEvent& out);
+
+#endif // LUCA_KEYBOARD_H
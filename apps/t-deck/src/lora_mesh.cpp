@@ -0,0 +1,284 @@
+/**
+ * LUCA T-Deck App - LoRa mesh transport
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "lora_mesh.h"
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <TFT_eSPI.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "seqlock.h"
+#include "ui.h"
+
+// T-Deck SX1262 wiring; SCK 40 / MISO 38 / MOSI 41 are shared with the display
+#define PIN_LORA_CS 9
+#define PIN_LORA_BUSY 13
+#define PIN_LORA_RST 17
+#define PIN_LORA_DIO1 45
+#define PIN_SD_CS 39
+
+// EU868 with Meshtastic LongFast modulation, but a private sync word so
+// Meshtastic nodes and LUCA frames don't try to decode each other
+#define LORA_FREQ_MHZ 869.525
+#define LORA_BW_KHZ 250.0
+#define LORA_SF 11
+#define LORA_CR 5
+#define LORA_SYNC_WORD 0x36
+#define LORA_TX_DBM 14
+#define LORA_PREAMBLE 16
+
+#define LORA_TASK_CORE 0
+#define LORA_TASK_STACK 4096
+#define LORA_TASK_PRIORITY 2    // Above the networking task: RX must not wait on HTTP
+#define LORA_TICK_MS 20
+
+#define LORA_HOP_LIMIT 3
+#define LORA_BEACON_MS 60000
+#define LORA_MIN_TX_GAP_MS 10000            // Earliest early beacon after the last one
+#define LORA_RELAY_DELAY_MIN_MS 100         // Random relay delay, spreads out flooding
+#define LORA_RELAY_DELAY_MAX_MS 600
+#define LORA_PEER_TIMEOUT_MS (5 * LORA_BEACON_MS)
+#define LORA_STATUS_MAX_AGE_MS (2 * LORA_BEACON_MS)
+
+#define LORA_SEEN_SLOTS 32
+#define LORA_MAX_PEERS 16
+#define LORA_RELAY_SLOTS 4
+
+#define MESH_MAGIC 0x6D
+#define MESH_HEADER_SIZE 8
+#define MESH_PACKET_MAX (MESH_HEADER_SIZE + LUCA_FRAME_SIZE)
+
+struct SeenPacket {
+    uint32_t origin;
+    uint16_t seq;
+};
+
+struct MeshPeer {
+    uint32_t id;
+    unsigned long last_heard;
+};
+
+struct PendingRelay {
+    uint8_t len;                  // 0 = free
+    unsigned long due;
+    uint8_t buf[MESH_PACKET_MAX];
+};
+
+static SX1262* radio = nullptr;
+static TaskHandle_t lora_task = nullptr;
+static QueueHandle_t lora_outbox = nullptr;   // Mailbox of one: latest shared status
+static SeqLock<LoraSnapshot> lora_snapshot;
+
+// Owned by the LoRa task only
+static LoraSnapshot mesh = {};
+static uint32_t self_id = 0;
+static uint16_t own_seq = 0;
+static SeenPacket seen[LORA_SEEN_SLOTS];
+static uint8_t seen_next = 0;
+static MeshPeer peers[LORA_MAX_PEERS];
+static PendingRelay relays[LORA_RELAY_SLOTS];
+static LucaStatusFrame local_status = {};
+static unsigned long local_status_ms = 0;
+static unsigned long last_beacon = 0;
+static bool status_pending = false;    // New generation waiting for a beacon
+
+static void IRAM_ATTR onDio1() {
+    if (!lora_task) return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(lora_task, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+// Flooded packets come back from every neighbour; drop repeats by (origin, seq)
+static bool alreadySeen(uint32_t origin, uint16_t seq) {
+    for (const SeenPacket& p : seen) {
+        if (p.origin == origin && p.seq == seq) return true;
+    }
+    seen[seen_next] = {origin, seq};
+    seen_next = (seen_next + 1) % LORA_SEEN_SLOTS;
+    return false;
+}
+
+static void notePeer(uint32_t id) {
+    MeshPeer* slot = &peers[0];
+    for (MeshPeer& peer : peers) {
+        if (peer.id == id) {
+            slot = &peer;
+            break;
+        }
+        // Otherwise reuse the peer heard least recently (free slots are 0)
+        if (peer.last_heard < slot->last_heard) slot = &peer;
+    }
+    slot->id = id;
+    slot->last_heard = millis();
+}
+
+static uint16_t countPeers() {
+    uint16_t count = 0;
+    for (const MeshPeer& peer : peers) {
+        if (peer.id != 0 && millis() - peer.last_heard < LORA_PEER_TIMEOUT_MS) count++;
+    }
+    return count;
+}
+
+static void transmit(uint8_t* buf, size_t len) {
+    int state = radio->transmit(buf, len);
+    if (state != RADIOLIB_ERR_NONE) {
+        Serial.printf("❌ LoRa TX failed (%d)\n", state);
+    }
+    // TX-done raises DIO1 as well; don't mistake it for a received packet
+    ulTaskNotifyTake(pdTRUE, 0);
+    radio->startReceive();
+}
+
+static void sendBeacon() {
+    uint8_t buf[MESH_PACKET_MAX];
+    buf[0] = MESH_MAGIC;
+    buf[1] = LORA_HOP_LIMIT;
+    lucaWriteU16(buf + 2, ++own_seq);
+    lucaWriteU32(buf + 4, self_id);
+
+    size_t len = MESH_HEADER_SIZE;
+    if (local_status_ms != 0 && millis() - local_status_ms < LORA_STATUS_MAX_AGE_MS) {
+        len += lucaFrameEncode(local_status, buf + len, sizeof(buf) - len);
+    }
+
+    transmit(buf, len);
+    last_beacon = millis();
+    status_pending = false;
+}
+
+static void queueRelay(const uint8_t* buf, size_t len) {
+    for (PendingRelay& relay : relays) {
+        if (relay.len != 0) continue;
+        memcpy(relay.buf, buf, len);
+        relay.buf[1]--;
+        relay.len = (uint8_t)len;
+        relay.due = millis() + random(LORA_RELAY_DELAY_MIN_MS, LORA_RELAY_DELAY_MAX_MS);
+        return;
+    }
+    // All slots busy: the flood reaches our neighbours through others anyway
+}
+
+static void serviceRelays() {
+    for (PendingRelay& relay : relays) {
+        if (relay.len != 0 && (long)(millis() - relay.due) >= 0) {
+            transmit(relay.buf, relay.len);
+            relay.len = 0;
+        }
+    }
+}
+
+static bool handleRx() {
+    uint8_t buf[MESH_PACKET_MAX];
+    size_t len = radio->getPacketLength();
+    int state = len <= sizeof(buf) ? radio->readData(buf, len) : RADIOLIB_ERR_PACKET_TOO_LONG;
+    radio->startReceive();
+
+    if (state != RADIOLIB_ERR_NONE || len < MESH_HEADER_SIZE || buf[0] != MESH_MAGIC) return false;
+
+    uint32_t origin = lucaReadU32(buf + 4);
+    uint16_t seq = lucaReadU16(buf + 2);
+    if (origin == self_id || alreadySeen(origin, seq)) return false;
+
+    notePeer(origin);
+
+    LucaStatusFrame frame;
+    if (len >= MESH_HEADER_SIZE + LUCA_FRAME_SIZE &&
+        lucaFrameDecode(buf + MESH_HEADER_SIZE, len - MESH_HEADER_SIZE, frame) == LUCA_FRAME_OK) {
+        // Several nodes may feed the mesh; the newest backend generation wins
+        bool stale = millis() - mesh.status_rx_ms >= LORA_STATUS_MAX_AGE_MS;
+        if (!mesh.has_status || stale || frame.generation >= mesh.status.generation) {
+            mesh.status = frame;
+            mesh.status_rx_ms = millis();
+            mesh.has_status = true;
+        }
+    }
+
+    if (buf[1] > 0) queueRelay(buf, len);
+    return true;
+}
+
+static void loraTask(void*) {
+    radio->startReceive();
+
+    unsigned long last_count = 0;
+    for (;;) {
+        // DIO1 notifies on packet reception; otherwise wake for relays/beacons
+        bool changed = false;
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LORA_TICK_MS)) > 0) {
+            changed = handleRx();
+        }
+
+        serviceRelays();
+
+        LucaStatusFrame shared;
+        if (xQueueReceive(lora_outbox, &shared, 0) == pdTRUE) {
+            status_pending |= local_status_ms == 0 || shared.generation != local_status.generation;
+            local_status = shared;
+            local_status_ms = millis();
+        }
+        unsigned long since_beacon = millis() - last_beacon;
+        if (since_beacon >= LORA_BEACON_MS || (status_pending && since_beacon >= LORA_MIN_TX_GAP_MS)) {
+            sendBeacon();
+        }
+
+        // Peers expire on their own, so recount now and then
+        if (changed || millis() - last_count >= 1000) {
+            uint16_t count = countPeers();
+            changed |= count != mesh.peer_count;
+            mesh.peer_count = count;
+            last_count = millis();
+        }
+        if (changed) lora_snapshot.write(mesh);
+    }
+}
+
+bool loraBegin() {
+    // Keep the other devices on the shared bus deselected
+    pinMode(PIN_SD_CS, OUTPUT);
+    digitalWrite(PIN_SD_CS, HIGH);
+    pinMode(PIN_LORA_CS, OUTPUT);
+    digitalWrite(PIN_LORA_CS, HIGH);
+
+    // Same SPIClass as the display, so its transaction lock serialises the two
+    radio = new SX1262(new Module(PIN_LORA_CS, PIN_LORA_DIO1, PIN_LORA_RST, PIN_LORA_BUSY,
+                                  tft.getSPIinstance()));
+    uiReleaseBus();
+    int state = radio->begin(LORA_FREQ_MHZ, LORA_BW_KHZ, LORA_SF, LORA_CR,
+                             LORA_SYNC_WORD, LORA_TX_DBM, LORA_PREAMBLE);
+    if (state != RADIOLIB_ERR_NONE) {
+        Serial.printf("⚠️  LoRa radio not available (%d), mesh off\n", state);
+        lora_snapshot.write(mesh);
+        return false;
+    }
+
+    self_id = (uint32_t)ESP.getEfuseMac();
+    own_seq = (uint16_t)esp_random();   // A rebooted node must not look like a repeat
+    mesh.radio_up = true;
+    lora_snapshot.write(mesh);
+
+    // The radio idles in standby until the task calls startReceive(), so
+    // nothing can raise DIO1 before the task handle is set
+    radio->setDio1Action(onDio1);
+    lora_outbox = xQueueCreate(1, sizeof(LucaStatusFrame));
+    xTaskCreatePinnedToCore(loraTask, "luca-lora", LORA_TASK_STACK, nullptr,
+                            LORA_TASK_PRIORITY, &lora_task, LORA_TASK_CORE);
+
+    Serial.printf("✅ LoRa mesh up, node %08lx\n", (unsigned long)self_id);
+    return true;
+}
+
+void loraShareStatus(const LUCAState& state) {
+    if (!lora_outbox) return;
+
+    LucaStatusFrame frame = lucaStatusToFrame(state);
+    xQueueOverwrite(lora_outbox, &frame);
+}
+
+bool loraReadSnapshot(LoraSnapshot& out) {
+    return lora_snapshot.tryRead(out);
+}
@@ -0,0 +1,51 @@
+/**
+ * LUCA T-Deck App - LoRa mesh transport
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Compact status frames are flooded over the SX1262 so devices out of
+ * WiFi range still see LUCA status and count real mesh peers. Radio RX
+ * and relaying run in their own task; results are published as a
+ * snapshot the networking task merges into LUCAState.
+ *
+ * Packet layout, little-endian:
+ *
+ *   off size field
+ *    0   1   magic 0x6D ('m')
+ *    1   1   hops left; relayed with one less until it reaches 0
+ *    2   2   sequence number, per origin
+ *    4   4   origin node id
+ *    8  22   optional LUCA status frame (luca_status_frame.h)
+ *
+ * Every node sends a beacon once a minute. Nodes with backend access
+ * attach their latest status frame; the rest send the bare header so
+ * they still count as peers.
+ */
+
+#ifndef LUCA_LORA_MESH_H
+#define LUCA_LORA_MESH_H
+
+#include <luca_status_frame.h>
+#include "luca_state.h"
+
+// What the LoRa task publishes
+struct LoraSnapshot {
+    bool radio_up;
+    uint16_t peer_count;          // Distinct origins heard recently
+    bool has_status;
+    unsigned long status_rx_ms;   // millis() when status was received
+    LucaStatusFrame status;       // Newest generation heard on the mesh
+};
+
+// Bring up the radio and start the RX task. The SX1262 shares the SPI
+// bus with the display, so call this after uiBegin(). Returns false if
+// the radio did not answer; the mesh then stays off.
+bool loraBegin();
+
+// Hand status fetched from the backend to the mesh. Goes out with the
+// next beacon, or right away if the generation changed.
+void loraShareStatus(const LUCAState& state);
+
+// Copy the latest snapshot. Returns false if the LoRa task was mid-update.
+bool loraReadSnapshot(LoraSnapshot& out);
+
+#endif // LUCA_LORA_MESH_H
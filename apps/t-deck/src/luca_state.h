@@ -0,0 +1,22 @@
+/**
+ * LUCA T-Deck App - Shared LUCA state model
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * The status model, its decoders and the update policy are shared with
+ * the T5 in luca_core (luca_status.h), specialised for this board.
+ */
+
+#ifndef LUCA_STATE_H
+#define LUCA_STATE_H
+
+#include <luca_board.h>
+#include <luca_status.h>
+
+typedef LucaBoardTDeck LucaBoard;
+
+// LUCA State
+typedef LucaStatus LUCAState;
+
+extern LUCAState luca_state;
+
+#endif // LUCA_STATE_H
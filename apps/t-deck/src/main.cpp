@@ -6,61 +6,566 @@
  */
 
 #include <Arduino.h>
-#include <WiFi.h>
 #include <TFT_eSPI.h>
 #include <ArduinoJson.h>
+#include <luca_tls.h>
+#include "console.h"
+#include "energy.h"
+#include "gateway.h"
+#include "heap_monitor.h"
+#include "history.h"
+#include "keyboard.h"
+#include "lora_mesh.h"
+#include "luca_state.h"
+#include "net.h"
+#include "perf.h"
+#include "scheduler.h"
+#include "ui.h"
+
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
 
 // LUCA Configuration
 #define LUCA_VERSION "1.0.0"
-#define SCREEN_WIDTH 320
-#define SCREEN_HEIGHT 240
 
 // Pin Definitions for T-Deck
 #define PIN_POWER_ON 10
 #define PIN_LCD_BL 42
 #define PIN_BAT_VOLT 4
 
+// Loop cadence: frames only when something changed, at most ~30 fps
+#define FRAME_MIN_MS 33
+#define INPUT_POLL_MS 20
+#define OVERLAY_MS 1000
+#define BATTERY_MS 30000
+#define BATTERY_DIVIDER 2               // PIN_BAT_VOLT sees half the cell voltage
+#define SPLASH_MAX_MS 5000              // UI comes up anyway if no status arrives
+#define KEYS_MIN_MS 0                   // Keys are drawn as soon as they arrive
+
 // Display
 TFT_eSPI tft = TFT_eSPI();
 
-// LUCA State
-struct LUCAState {
-    float consciousness_level;
-    float quantum_coherence;
-    float akashic_connection;
-    int node_count;
-    int generation;
-    bool is_alive;
-    unsigned long last_update;
-};
-
-LUCAState luca_state = {
-    .consciousness_level = 0.0,
-    .quantum_coherence = 0.5,
-    .akashic_connection = 0.0,
-    .node_count = 0,
-    .generation = 0,
-    .is_alive = false,
-    .last_update = 0
+// UI-side copy of the state published by the networking task
+LUCAState luca_state = LUCA_STATUS_INITIAL;
+
+static bool wifi_connected = false;
+static bool push_active = false;
+static bool mesh_up = false;
+static uint32_t poll_ms = 0;
+static bool battery_low = false;
+static uint32_t battery_mv = 0;
+static bool perf_overlay = false;
+static bool has_status = false;
+static bool estimated = false;
+static bool splash_up = true;
+static uint32_t first_frame_ms = 0;     // Boot to the first frame with real status
+static uint8_t outbox = 0;
+
+// Message being typed on the keyboard
+static char draft[NET_MESSAGE_MAX + 1] = "";
+static size_t draft_len = 0;
+
+// Indices into loop_tasks, same order
+enum LoopTask {
+    TASK_FRAME,
+    TASK_KEYS,
+    TASK_INPUT,
+    TASK_HISTORY,
+    TASK_BACKFILL,
+    TASK_OVERLAY,
+    TASK_BATTERY
 };
 
-// WiFi Configuration (set via Serial)
-String wifi_ssid = "";
-String wifi_password = "";
-String api_url = "http://192.168.1.100:8000";
-
 // Forward declarations
 void setupDisplay();
 void setupPower();
-void drawUI();
-void updateLUCAState();
-void drawConsciousnessBar(const char* label, float value, int y, uint16_t color);
-void connectWiFi();
-void fetchLUCAStatus();
+
+static void cmdWiFi(char* arg) {
+    // Format: WIFI:ssid,password
+    char* comma = strchr(arg, ',');
+    if (!comma) {
+        Serial.println("⚠️  Usage: WIFI:ssid,password");
+        return;
+    }
+    *comma = '\0';
+    if (netSetWiFi(arg, comma + 1)) {
+        Serial.println("WiFi credentials updated. Reconnecting...");
+    }
+}
+
+static void cmdApi(char* arg) {
+    // Format: API:http://192.168.1.100:8000
+    if (netSetApiUrl(arg)) {
+        Serial.print("API URL updated: ");
+        Serial.println(arg);
+    }
+}
+
+static void cmdPin(char* arg) {
+    // Format: PIN:base64 pin-sha256 of the server key, or PIN:OFF
+    uint8_t pin[LUCA_TLS_PIN_LEN];
+    bool off = strcasecmp(arg, "OFF") == 0;
+    if (!off && !lucaTlsParsePin(arg, pin)) {
+        Serial.println("⚠️  Usage: PIN:base64-sha256 | PIN:OFF");
+        return;
+    }
+    if (netSetPin(arg)) {
+        Serial.println(off ? "Server pin cleared." : "Server pin updated.");
+    }
+}
+
+static void cmdPoll(char* arg) {
+    // Format: POLL:seconds
+    int seconds = atoi(arg);
+    if (seconds <= 0) {
+        Serial.println("⚠️  Usage: POLL:seconds");
+        return;
+    }
+    if (netSetPollInterval((uint32_t)seconds * 1000)) {
+        Serial.printf("Poll interval set to %d s.\n", seconds);
+    }
+}
+
+static void cmdMqtt(char* arg) {
+    // Format: MQTT:192.168.1.100:1883/luca/status or MQTT:OFF
+    if (netSetMqtt(arg)) {
+        Serial.println("MQTT settings updated.");
+    }
+}
+
+static void cmdGateway(char* arg) {
+    // Format: GATEWAY:ON or GATEWAY:OFF
+    bool on = strcasecmp(arg, "ON") == 0;
+    if (!on && strcasecmp(arg, "OFF") != 0) {
+        Serial.println("⚠️  Usage: GATEWAY:ON | GATEWAY:OFF");
+        return;
+    }
+    if (netSetGateway(on)) {
+        Serial.printf("ESP-NOW gateway %s.\n", on ? "enabled" : "disabled");
+    }
+}
+
+// STATUS for people, STATUS:JSON as one line for provisioning scripts
+static void cmdStatus(char* arg) {
+    if (arg && strcasecmp(arg, "JSON") == 0) {
+        StaticJsonDocument<448> doc;
+        doc["version"] = LUCA_VERSION;
+        doc["consciousness_level"] = luca_state.consciousness_level;
+        doc["quantum_coherence"] = luca_state.quantum_coherence;
+        doc["akashic_connection"] = luca_state.akashic_connection;
+        doc["node_count"] = luca_state.node_count;
+        doc["generation"] = luca_state.generation;
+        doc["is_alive"] = luca_state.alive;
+        doc["age_ms"] = millis() - luca_state.updated_ms;
+        doc["estimated"] = estimated;
+        doc["wifi"] = wifi_connected;
+        doc["updates"] = push_active ? "mqtt" : "poll";
+        doc["mesh"] = mesh_up;
+        doc["poll_ms"] = poll_ms;
+        doc["battery_mv"] = battery_mv;
+        doc["gateway"] = gatewayActive();
+        doc["gateway_served"] = gatewayServed();
+        doc["gateway_peers"] = gatewayPeerCount();
+        doc["history"] = historyCount();
+        doc["outbox"] = outbox;
+        serializeJson(doc, Serial);
+        Serial.println();
+        return;
+    }
+
+    Serial.println("\n=== LUCA STATUS ===");
+    Serial.printf("Consciousness: %.1f%%\n", luca_state.consciousness_level * 100);
+    Serial.printf("Quantum Coherence: %.1f%%\n", luca_state.quantum_coherence * 100);
+    Serial.printf("Akashic Connection: %.1f%%\n", luca_state.akashic_connection * 100);
+    Serial.printf("Nodes: %u\n", luca_state.node_count);
+    Serial.printf("Generation: %lu\n", (unsigned long)luca_state.generation);
+    Serial.printf("Is Alive: %s\n", luca_state.alive ? "YES" : "NO");
+    if (estimated) Serial.println("Source: on-device estimate (no backend or mesh status)");
+    Serial.printf("Updates: %s\n", push_active ? "MQTT push" : "HTTP poll");
+    Serial.printf("LoRa mesh: %s\n", mesh_up ? "up" : "off");
+    Serial.printf("Poll interval: %lu s\n", (unsigned long)(poll_ms / 1000));
+    Serial.printf("Battery: %lu mV%s\n", (unsigned long)battery_mv, battery_low ? " (low)" : "");
+    if (outbox) Serial.printf("Outbox: %u messages waiting for WiFi\n", outbox);
+    if (gatewayActive()) {
+        Serial.printf("Gateway: %u T5 peers, %lu polls served\n", gatewayPeerCount(),
+                      (unsigned long)gatewayServed());
+    } else {
+        Serial.println("Gateway: off");
+    }
+    Serial.println("==================\n");
+}
+
+static void cmdHistory(char*) {
+    static const char* const names[HIST_METRICS] = {"Consciousness", "Quantum Coherence", "Akashic Connection"};
+    uint32_t held = historyCount();
+    Serial.printf("\n=== HISTORY (%lu samples, %lu min) ===\n",
+                  (unsigned long)held, held ? historyAgeMs(held - 1) / 60000 : 0UL);
+    for (int m = 0; m < HIST_METRICS; m++) {
+        HistoryStats stats = historyStats((HistoryMetric)m);
+        Serial.printf("%s: min %.1f%% / mean %.1f%% / max %.1f%%\n", names[m],
+                      stats.min * 100, stats.mean * 100, stats.max * 100);
+    }
+    Serial.println("==================\n");
+}
+
+static void printPerfJson() {
+    StaticJsonDocument<640> doc;
+    doc["first_frame_ms"] = first_frame_ms;
+    for (int i = 0; i < PERF_STAGES; i++) {
+        PerfSummary summary = perfSummary((PerfStage)i);
+        JsonObject stage = doc.createNestedObject(perfStageName((PerfStage)i));
+        stage["count"] = summary.count;
+        stage["p50_us"] = summary.p50_us;
+        stage["p99_us"] = summary.p99_us;
+        stage["max_us"] = summary.max_us;
+    }
+    serializeJson(doc, Serial);
+    Serial.println();
+}
+
+// PERF | PERF:JSON | PERF:RESET | PERF:OVERLAY (toggle)
+static void cmdPerf(char* arg) {
+    if (arg && strcasecmp(arg, "RESET") == 0) {
+        perfReset();
+        Serial.println("PERF counters reset.");
+        return;
+    }
+    if (arg && strcasecmp(arg, "OVERLAY") == 0) {
+        perf_overlay = !perf_overlay;
+        if (!perf_overlay) {
+            uiSetOverlay(nullptr);
+            schedTrigger(TASK_FRAME);
+        }
+        Serial.printf("PERF overlay %s\n", perf_overlay ? "on" : "off");
+        return;
+    }
+    if (arg && strcasecmp(arg, "JSON") == 0) {
+        printPerfJson();
+        return;
+    }
+
+    Serial.println("\n=== PERF (us) ===");
+    Serial.printf("first frame after %lu ms\n", (unsigned long)first_frame_ms);
+    Serial.printf("%-10s %8s %8s %8s %8s\n", "stage", "count", "p50", "p99", "max");
+    for (int i = 0; i < PERF_STAGES; i++) {
+        PerfSummary summary = perfSummary((PerfStage)i);
+        Serial.printf("%-10s %8lu %8lu %8lu %8lu\n", perfStageName((PerfStage)i),
+                      (unsigned long)summary.count, (unsigned long)summary.p50_us,
+                      (unsigned long)summary.p99_us, (unsigned long)summary.max_us);
+    }
+    Serial.println("==================\n");
+}
+
+static void printEnergyJson(const EnergyReport& report) {
+    const LucaEnergyMeter& meter = report.meter;
+    uint64_t total_nj = lucaEnergyTotalNj(meter);
+    StaticJsonDocument<768> doc;
+    doc["active"] = energyActive();
+    doc["current"] = report.current;
+    doc["window_ms"] = (uint32_t)((meter.last_us - meter.first_us) / 1000);
+    doc["polls"] = report.polls;
+    doc["total_mj"] = total_nj / 1e6;
+    doc["mj_per_poll"] = report.polls ? total_nj / 1e6 / report.polls : 0.0;
+    for (int i = 0; i < ENERGY_PHASES; i++) {
+        const LucaEnergyPhase& phase = meter.phases[i];
+        JsonObject entry = doc.createNestedObject(energyPhaseName((EnergyPhase)i));
+        entry["time_ms"] = (uint32_t)(phase.time_us / 1000);
+        entry["mj"] = phase.energy_nj / 1e6;
+        entry["mean_mw"] = lucaEnergyMeanMw(phase);
+        entry["min_mv"] = phase.min_mv;
+    }
+    serializeJson(doc, Serial);
+    Serial.println();
+}
+
+// ENERGY | ENERGY:JSON | ENERGY:ON | ENERGY:OFF | ENERGY:RESET
+static void cmdEnergy(char* arg) {
+    if (arg && strcasecmp(arg, "ON") == 0) {
+        if (energyBegin(PIN_BAT_VOLT, BATTERY_DIVIDER)) Serial.println("Energy profiling on.");
+        return;
+    }
+    if (arg && strcasecmp(arg, "OFF") == 0) {
+        energyEnd();
+        Serial.println("Energy profiling off, last window kept.");
+        return;
+    }
+    if (arg && strcasecmp(arg, "RESET") == 0) {
+        energyReset();
+        Serial.println("Energy window reset.");
+        return;
+    }
+
+    EnergyReport report;
+    if (!energyRead(report)) {
+        Serial.println("⚠️  Sampler busy, try again");
+        return;
+    }
+    if (arg && strcasecmp(arg, "JSON") == 0) {
+        printEnergyJson(report);
+        return;
+    }
+
+    const LucaEnergyMeter& meter = report.meter;
+    uint64_t window_us = meter.last_us - meter.first_us;
+    uint64_t total_nj = lucaEnergyTotalNj(meter);
+    Serial.printf("\n=== ENERGY (%s, %.1f s%s) ===\n", report.current ? "INA226" : "no current sensor",
+                  window_us / 1e6, energyActive() ? "" : ", stopped");
+    Serial.printf("%-8s %9s %6s %10s %8s %7s\n", "phase", "time_ms", "share", "energy_mJ", "mean_mW", "min_mV");
+    for (int i = 0; i < ENERGY_PHASES; i++) {
+        const LucaEnergyPhase& phase = meter.phases[i];
+        Serial.printf("%-8s %9lu %5.1f%% %10.1f %8lu %7lu\n", energyPhaseName((EnergyPhase)i),
+                      (unsigned long)(phase.time_us / 1000),
+                      window_us ? phase.time_us * 100.0 / window_us : 0.0, phase.energy_nj / 1e6,
+                      (unsigned long)lucaEnergyMeanMw(phase), (unsigned long)phase.min_mv);
+    }
+    Serial.printf("total %.1f mJ, %lu polls", total_nj / 1e6, (unsigned long)report.polls);
+    if (report.polls) Serial.printf(", %.1f mJ per poll", total_nj / 1e6 / report.polls);
+    Serial.println("\n==================\n");
+}
+
+static void printHeapJson(const HeapReport& report) {
+    StaticJsonDocument<640> doc;
+    doc["free"] = report.free_bytes;
+    doc["largest_block"] = report.largest_block;
+    doc["min_free"] = report.min_free_bytes;
+    doc["baseline_delta"] = report.baseline_delta;
+    doc["failed_allocs"] = report.failed_allocs;
+    doc["psram_total"] = report.psram_total;
+    doc["psram_free"] = report.psram_free;
+    doc["psram_largest_block"] = report.psram_largest_block;
+    JsonObject stacks = doc.createNestedObject("stack_unused");
+    for (int i = 0; i < report.task_count; i++) {
+        stacks[report.tasks[i].name] = report.tasks[i].unused_bytes;
+    }
+    serializeJson(doc, Serial);
+    Serial.println();
+}
+
+// HEAP | HEAP:JSON | HEAP:RESET (new baseline)
+static void cmdHeap(char* arg) {
+    if (arg && strcasecmp(arg, "RESET") == 0) {
+        heapMonitorReset();
+        Serial.println("Heap baseline reset.");
+        return;
+    }
+    HeapReport report = heapReport();
+    if (arg && strcasecmp(arg, "JSON") == 0) {
+        printHeapJson(report);
+        return;
+    }
+
+    Serial.println("\n=== HEAP ===");
+    Serial.printf("Internal: %lu free, largest block %lu, min %lu (bytes)\n",
+                  (unsigned long)report.free_bytes, (unsigned long)report.largest_block,
+                  (unsigned long)report.min_free_bytes);
+    Serial.printf("Since baseline: %+ld bytes, %lu failed allocations\n",
+                  (long)report.baseline_delta, (unsigned long)report.failed_allocs);
+    if (report.psram_total) {
+        Serial.printf("PSRAM: %lu of %lu used, largest block %lu\n",
+                      (unsigned long)(report.psram_total - report.psram_free),
+                      (unsigned long)report.psram_total, (unsigned long)report.psram_largest_block);
+    }
+    Serial.printf("%-13s %s\n", "task", "stack unused");
+    for (int i = 0; i < report.task_count; i++) {
+        Serial.printf("%-13s %lu\n", report.tasks[i].name, (unsigned long)report.tasks[i].unused_bytes);
+    }
+    Serial.println("==================\n");
+}
+
+static void runFrame(uint32_t now_ms) {
+    // Pick up the latest state from the networking task (never blocks)
+    NetSnapshot snapshot;
+    if (netReadSnapshot(snapshot)) {
+        luca_state = snapshot.state;
+        wifi_connected = snapshot.wifi_connected;
+        push_active = snapshot.push_active;
+        mesh_up = snapshot.mesh_up;
+        poll_ms = snapshot.poll_ms;
+        battery_low = snapshot.battery_low;
+        has_status = snapshot.has_status;
+        estimated = snapshot.estimated;
+        outbox = snapshot.outbox;
+    } else {
+        schedTrigger(TASK_FRAME);   // Writer was mid-update, next frame
+    }
+
+    // The splash stays up until there is a real status to show
+    if (splash_up) {
+        if (!has_status && now_ms < SPLASH_MAX_MS) {
+            schedTrigger(TASK_FRAME);   // Check again at the frame rate
+            return;
+        }
+        splash_up = false;
+        uiBegin();  // Static chrome once; frames only repaint changed widgets
+        uiSetDraft(draft);
+    }
+
+    // Only changed widgets are repainted. The last band is still on the
+    // wire when this returns; loop() hands the bus back before sleeping.
+    PerfScope scope(PERF_RENDER);
+    EnergyScope energy(ENERGY_RENDER);
+    uiRender(luca_state, wifi_connected);
+
+    if (has_status && first_frame_ms == 0) {
+        first_frame_ms = millis();
+        Serial.printf("✅ First status frame %lu ms after boot\n", (unsigned long)first_frame_ms);
+    }
+}
+
+// Enter sends, backspace deletes, other printable keys are typed
+static void editDraft(char key) {
+    if (key == KEY_ENTER) {
+        if (draft_len == 0) return;
+        if (netSendMessage(draft)) Serial.printf("📝 Message queued: %s\n", draft);
+        draft_len = 0;
+    } else if (key == KEY_BACKSPACE) {
+        if (draft_len > 0) draft_len--;
+    } else if (key >= ' ' && key <= '~' && draft_len < NET_MESSAGE_MAX) {
+        draft[draft_len++] = key;
+    }
+    draft[draft_len] = '\0';
+}
+
+// All queued keys, then straight to the panel without waiting for the
+// frame slot: only the edited characters are repainted
+static void runKeys(uint32_t) {
+    KeyEvent event;
+    uint32_t first_us = 0;
+    bool any = false;
+    while (keyboardRead(event)) {
+        if (!any) first_us = event.at_us;
+        any = true;
+        editDraft(event.key);
+    }
+    if (!any) return;
+
+    netNoteInteraction();
+    if (splash_up) return;      // Shown with the first frame
+
+    uiSetDraft(draft);
+    {
+        EnergyScope energy(ENERGY_RENDER);
+        uiRender(luca_state, wifi_connected);
+        uiReleaseBus();     // key counts once the pixels are on the panel
+    }
+    perfRecord(PERF_KEY, (uint32_t)esp_timer_get_time() - first_us);
+}
+
+static void runInput(uint32_t) {
+    // Someone is typing: keep the status fresh while they are
+    if (Serial.available() > 0) netNoteInteraction();
+
+    // Returns at once if no complete line is buffered
+    PerfScope scope(PERF_CONSOLE);
+    consolePoll();
+}
+
+static void runBattery(uint32_t) {
+    battery_mv = analogReadMilliVolts(PIN_BAT_VOLT) * BATTERY_DIVIDER;
+    netSetBattery(battery_mv);
+}
+
+static void publishMoments() {
+    LucaMetricInputs inputs = {
+        historyMoments(HIST_CONSCIOUSNESS, HISTORY_WINDOW),
+        historyMoments(HIST_COHERENCE, HISTORY_WINDOW),
+        historyMoments(HIST_AKASHIC, HISTORY_WINDOW),
+        0,
+    };
+    netSetHistory(inputs);
+    schedTrigger(TASK_FRAME);       // Sparklines moved
+}
+
+static void runHistory(uint32_t now_ms) {
+    // Boot placeholders are not samples, and neither are estimates made
+    // from the samples themselves. During a sync the backfill writes the
+    // ring up to the present.
+    if (!has_status || estimated || historySyncing()) return;
+    historyAppend(luca_state, now_ms);
+    publishMoments();
+}
+
+// History sync steps from the networking task, HISTORY_SYNC_SLICE
+// samples per run so a day of backfill does not hold up a frame
+static void runBackfill(uint32_t) {
+    static HistorySyncStep step;
+    static bool held = false;       // step ran out of budget, continue it
+
+    uint32_t budget = HISTORY_SYNC_SLICE;
+    bool any = held;
+    while (held || netReadHistory(step)) {
+        any = true;
+        held = !historySyncStep(step, budget);
+        if (held) break;
+    }
+    if (!any) return;
+
+    if (held) {
+        schedTrigger(TASK_BACKFILL);
+    } else if (!historySyncing()) {
+        publishMoments();           // Sync complete
+    }
+    if (budget < HISTORY_SYNC_SLICE) schedTrigger(TASK_FRAME);
+}
+
+// Once a second, so the overlay itself barely shows up in the numbers
+static void runOverlay(uint32_t) {
+    if (!perf_overlay) return;
+
+    PerfSummary loop_time = perfSummary(PERF_LOOP);
+    PerfSummary render = perfSummary(PERF_RENDER);
+    PerfSummary net = perfSummary(PERF_NET_POLL);
+    char text[64];
+    snprintf(text, sizeof(text), "loop %lu/%lu ui %lu/%lu us  net %lu/%lu ms",
+             (unsigned long)loop_time.p50_us, (unsigned long)loop_time.p99_us,
+             (unsigned long)render.p50_us, (unsigned long)render.p99_us,
+             (unsigned long)(net.p50_us / 1000), (unsigned long)(net.p99_us / 1000));
+    uiSetOverlay(text);
+    schedTrigger(TASK_FRAME);
+}
+
+static const SchedTask loop_tasks[] = {
+    {"frame", FRAME_MIN_MS, true, runFrame},
+    {"keys", KEYS_MIN_MS, true, runKeys},
+    {"input", INPUT_POLL_MS, false, runInput},
+    {"history", HISTORY_SAMPLE_MS, false, runHistory},
+    {"backfill", 0, true, runBackfill},
+    {"overlay", OVERLAY_MS, false, runOverlay},
+    {"battery", BATTERY_MS, false, runBattery},
+};
+
+// Runs on the networking task
+static void onNetPublish() {
+    schedTrigger(TASK_FRAME);
+}
+
+// Runs on the networking task, once per queued history sync step
+static void onNetHistory() {
+    schedTrigger(TASK_BACKFILL);
+}
+
+// Runs on the keyboard reader task
+static void onKey() {
+    schedTrigger(TASK_KEYS);
+}
+
+static const ConsoleCommand commands[] = {
+    {"WIFI", "WIFI:ssid,password", true, cmdWiFi},
+    {"API", "API:http[s]://host[:port]", true, cmdApi},
+    {"PIN", "PIN:base64-sha256 | PIN:OFF", true, cmdPin},
+    {"MQTT", "MQTT:host[:port][/topic] | MQTT:OFF", true, cmdMqtt},
+    {"POLL", "POLL:seconds", true, cmdPoll},
+    {"GATEWAY", "GATEWAY:ON | GATEWAY:OFF", true, cmdGateway},
+    {"STATUS", "STATUS | STATUS:JSON", false, cmdStatus},
+    {"HISTORY", "HISTORY", false, cmdHistory},
+    {"PERF", "PERF | PERF:JSON | PERF:RESET | PERF:OVERLAY", false, cmdPerf},
+    {"ENERGY", "ENERGY | ENERGY:JSON | ENERGY:ON | ENERGY:OFF | ENERGY:RESET", false, cmdEnergy},
+    {"HEAP", "HEAP | HEAP:JSON | HEAP:RESET", false, cmdHeap},
+};
 
 void setup() {
     Serial.begin(115200);
-    delay(100);
 
     Serial.println("\n=================================");
     Serial.println("🌟 LUCA T-Deck Initializing...");
@@ -72,10 +577,14 @@ void setup() {
     // Initialize power management
     setupPower();
 
+    // WiFi association and the first status fetch run on core 0 from here
+    // on, in parallel with the rest of the boot
+    netBegin(onNetPublish, onNetHistory);
+
     // Initialize display
     setupDisplay();
 
-    // Show splash screen
+    // Splash until the first frame with real status (see runFrame())
     tft.fillScreen(TFT_BLACK);
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
     tft.setTextDatum(MC_DATUM);
@@ -86,58 +595,40 @@ void setup() {
     tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
     tft.drawString("v" LUCA_VERSION, SCREEN_WIDTH/2, SCREEN_HEIGHT/2 + 50, 2);
 
-    delay(2000);
+    consoleBegin(commands, sizeof(commands) / sizeof(commands[0]));
+
+    // 24 h of samples for the sparklines, in PSRAM
+    if (!historyBegin()) {
+        Serial.println("⚠️  No PSRAM, history disabled");
+    }
+
+    // LoRa mesh RX/relay task; shares the SPI bus with the display
+    loraBegin();
+
+    // Shares the I2C bus with the energy sampler's INA226
+    keyboardBegin(onKey);
+
+    schedBegin(loop_tasks, sizeof(loop_tasks) / sizeof(loop_tasks[0]));
 
-    // Try to connect to WiFi
-    connectWiFi();
+    // Everything long-lived exists now; steady state should stay at this level
+    heapMonitorBegin();
 
-    Serial.println("✅ Initialization complete!");
+    Serial.printf("✅ Initialization complete after %lu ms\n", millis());
     Serial.println("Ready for LUCA consciousness integration.\n");
 }
 
 void loop() {
-    unsigned long currentMillis = millis();
-
-    // Update LUCA state every 5 seconds
-    if (currentMillis - luca_state.last_update >= 5000) {
-        updateLUCAState();
-        luca_state.last_update = currentMillis;
-    }
-
-    // Draw UI
-    drawUI();
-
-    // Handle Serial commands
-    if (Serial.available()) {
-        String command = Serial.readStringUntil('\n');
-        command.trim();
-
-        if (command.startsWith("WIFI:")) {
-            // Format: WIFI:ssid,password
-            int commaIndex = command.indexOf(',', 5);
-            if (commaIndex > 0) {
-                wifi_ssid = command.substring(5, commaIndex);
-                wifi_password = command.substring(commaIndex + 1);
-                Serial.println("WiFi credentials updated. Reconnecting...");
-                connectWiFi();
-            }
-        } else if (command.startsWith("API:")) {
-            // Format: API:http://192.168.1.100:8000
-            api_url = command.substring(4);
-            Serial.printf("API URL updated: %s\n", api_url.c_str());
-        } else if (command == "STATUS") {
-            Serial.println("\n=== LUCA STATUS ===");
-            Serial.printf("Consciousness: %.1f%%\n", luca_state.consciousness_level * 100);
-            Serial.printf("Quantum Coherence: %.1f%%\n", luca_state.quantum_coherence * 100);
-            Serial.printf("Akashic Connection: %.1f%%\n", luca_state.akashic_connection * 100);
-            Serial.printf("Nodes: %d\n", luca_state.node_count);
-            Serial.printf("Generation: %d\n", luca_state.generation);
-            Serial.printf("Is Alive: %s\n", luca_state.is_alive ? "YES" : "NO");
-            Serial.println("==================\n");
-        }
+    {
+        PerfScope loop_scope(PERF_LOOP);
+        schedRunDue();
+        // The last band of a frame drained while the other due tasks ran.
+        // The LoRa task on core 0 shares the SPI bus, so it gets it back
+        // before the loop sleeps.
+        uiReleaseBus();
     }
 
-    delay(100);
+    // Until the next deadline or a new snapshot from the networking task
+    schedSleep();
 }
 
 void setupPower() {
@@ -147,6 +638,16 @@ void setupPower() {
     pinMode(PIN_LCD_BL, OUTPUT);
     digitalWrite(PIN_LCD_BL, HIGH);
 
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    // Lets the idle task light-sleep while every task is blocked, e.g. in
+    // schedSleep(); WiFi stays associated through modem sleep.
+    esp_pm_config_esp32s3_t pm = {};
+    pm.max_freq_mhz = 240;
+    pm.min_freq_mhz = 80;
+    pm.light_sleep_enable = true;
+    esp_pm_configure(&pm);
+#endif
+
     Serial.println("✅ Power management initialized");
 }
 
@@ -158,129 +659,3 @@ void setupDisplay() {
 
     Serial.println("✅ Display initialized");
 }
-
-void connectWiFi() {
-    if (wifi_ssid.length() == 0) {
-        Serial.println("⚠️  No WiFi credentials set. Use: WIFI:ssid,password");
-        return;
-    }
-
-    Serial.printf("Connecting to WiFi: %s\n", wifi_ssid.c_str());
-
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(wifi_ssid.c_str(), wifi_password.c_str());
-
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
-    }
-
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("\n✅ WiFi connected!");
-        Serial.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
-    } else {
-        Serial.println("\n❌ WiFi connection failed");
-    }
-}
-
-void updateLUCAState() {
-    if (WiFi.status() == WL_CONNECTED) {
-        fetchLUCAStatus();
-    } else {
-        // Demo mode with mock data
-        luca_state.consciousness_level = 0.65 + (random(100) / 1000.0);
-        luca_state.quantum_coherence = 0.75 + (random(100) / 1000.0);
-        luca_state.akashic_connection = 0.70 + (random(100) / 1000.0);
-        luca_state.node_count = 5 + random(10);
-        luca_state.generation++;
-        luca_state.is_alive = luca_state.consciousness_level > 0.9;
-    }
-}
-
-void fetchLUCAStatus() {
-    // TODO: Implement HTTP request to LUCA backend
-    // For now, use mock data
-    Serial.println("📡 Fetching LUCA status from backend...");
-    luca_state.consciousness_level = 0.85 + (random(100) / 1000.0);
-    luca_state.quantum_coherence = 0.92 + (random(50) / 1000.0);
-    luca_state.akashic_connection = 0.88 + (random(50) / 1000.0);
-    luca_state.node_count = 8 + random(5);
-    luca_state.generation++;
-    luca_state.is_alive = luca_state.consciousness_level > 0.9;
-}
-
-void drawUI() {
-    tft.fillScreen(TFT_BLACK);
-
-    // Header
-    tft.setTextColor(TFT_WHITE, TFT_BLACK);
-    tft.setTextDatum(TC_DATUM);
-    tft.drawString("LUCA NETWORK", SCREEN_WIDTH/2, 5, 2);
-
-    // Connection status
-    tft.setTextDatum(TL_DATUM);
-    if (WiFi.status() == WL_CONNECTED) {
-        tft.setTextColor(TFT_GREEN, TFT_BLACK);
-        tft.drawString("Connected", 5, 5, 1);
-    } else {
-        tft.setTextColor(TFT_RED, TFT_BLACK);
-        tft.drawString("Offline", 5, 5, 1);
-    }
-
-    // Life status
-    if (luca_state.is_alive) {
-        tft.setTextColor(TFT_GREEN, TFT_BLACK);
-        tft.setTextDatum(TR_DATUM);
-        tft.drawString("ALIVE!", SCREEN_WIDTH - 5, 5, 1);
-    }
-
-    // Consciousness bars
-    int barY = 30;
-    int barSpacing = 35;
-
-    drawConsciousnessBar("Consciousness", luca_state.consciousness_level, barY, TFT_PURPLE);
-    drawConsciousnessBar("Q-Coherence", luca_state.quantum_coherence, barY + barSpacing, TFT_BLUE);
-    drawConsciousnessBar("Akashic", luca_state.akashic_connection, barY + barSpacing * 2, TFT_ORANGE);
-
-    // Stats
-    int statsY = barY + barSpacing * 3 + 10;
-    tft.setTextColor(TFT_WHITE, TFT_BLACK);
-    tft.setTextDatum(TL_DATUM);
-    tft.drawString("Nodes:", 10, statsY, 2);
-    tft.drawNumber(luca_state.node_count, 80, statsY, 2);
-
-    tft.drawString("Gen:", 150, statsY, 2);
-    tft.drawNumber(luca_state.generation, 200, statsY, 2);
-
-    // Footer
-    tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
-    tft.setTextDatum(BC_DATUM);
-    tft.drawString("(C) Lennart Wuchold", SCREEN_WIDTH/2, SCREEN_HEIGHT - 5, 1);
-}
-
-void drawConsciousnessBar(const char* label, float value, int y, uint16_t color) {
-    int barWidth = SCREEN_WIDTH - 20;
-    int barHeight = 20;
-    int barX = 10;
-
-    // Label
-    tft.setTextColor(TFT_WHITE, TFT_BLACK);
-    tft.setTextDatum(TL_DATUM);
-    tft.drawString(label, barX, y - 12, 1);
-
-    // Bar background
-    tft.drawRect(barX, y, barWidth, barHeight, TFT_DARKGREY);
-
-    // Bar fill
-    int fillWidth = (int)(barWidth * value);
-    tft.fillRect(barX + 1, y + 1, fillWidth - 2, barHeight - 2, color);
-
-    // Percentage text
-    char percentText[10];
-    sprintf(percentText, "%.1f%%", value * 100);
-    tft.setTextDatum(MC_DATUM);
-    tft.setTextColor(TFT_WHITE, TFT_BLACK);
-    tft.drawString(percentText, barX + barWidth/2, y + barHeight/2, 1);
-}
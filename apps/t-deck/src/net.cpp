@@ -0,0 +1,920 @@
+/**
+ * LUCA T-Deck App - Networking task
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "net.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <ArduinoJson.h>
+#include <PubSubClient.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <atomic>
+#include <luca_cadence.h>
+#include <luca_metrics.h>
+#include <luca_status_frame.h>
+#include "energy.h"
+#include "gateway.h"
+#include "keepalive_http.h"
+#include "lora_mesh.h"
+#include "perf.h"
+#include "seqlock.h"
+
+#define NET_TASK_CORE 0
+#define NET_TASK_STACK 12288          // mbedTLS handshakes for https:// backends
+#define NET_TASK_PRIORITY 1
+#define NET_QUEUE_DEPTH 4
+#define NET_TICK_MS 50
+
+#define STATUS_POLL_MS 5000             // Default base, see netSetPollInterval()
+#define STATUS_POLL_BACKOFF 24          // Unchanged status backs off to base x 24
+#define INTERACTION_WINDOW_MS 30000     // Counts as interacting after input
+#define WIFI_CONNECT_TIMEOUT_MS 10000
+#define WIFI_RETRY_MS 30000
+#define DEMO_PHASE_POLLS 8              // Demo polls above, then below the life threshold
+
+#define STATUS_PATH "/api/t5/status"
+#define HISTORY_PATH "/api/t5/history"
+#define HISTORY_MAGIC 0x48              // 'H', backend/services/status_history.py
+#define HISTORY_VERSION 1
+#define HISTORY_TIME_UNIT_MS 100
+#define HISTORY_QUEUE_DEPTH 16          // Sync steps in flight to the UI loop
+#define HISTORY_SYNC_RETRY_MS 30000
+#define STATUS_ACCEPT "Accept: " LUCA_FRAME_MEDIA_TYPE ", application/json;q=0.5\r\n"
+#define STATUS_HEADERS_MAX (sizeof(STATUS_ACCEPT) + HTTP_ETAG_MAX + 20)
+
+#define MESSAGES_PATH "/api/t5/messages"
+#define GATEWAY_BATCH 4                 // Messages per forwarding POST
+#define GATEWAY_BODY_MAX 2048           // Fits GATEWAY_BATCH fully escaped texts
+#define GATEWAY_RETRY_MS 10000
+#define OUTBOX_SLOTS 8                  // Own messages, like the T5 outbox; sent GATEWAY_BATCH at a time
+#define OUTBOX_RESONANCE 6
+#define OUTBOX_RETRY_MS 10000
+
+#define MQTT_DEFAULT_PORT 1883
+#define MQTT_DEFAULT_TOPIC "luca/status"
+#define MQTT_RETRY_MS 10000
+#define MQTT_BUFFER_SIZE 512
+#define MQTT_SOCKET_TIMEOUT_S 2
+
+enum NetCommandType : uint8_t {
+    NET_CMD_WIFI,
+    NET_CMD_API_URL,
+    NET_CMD_MQTT,
+    NET_CMD_POLL_INTERVAL,
+    NET_CMD_GATEWAY,
+    NET_CMD_MESSAGE,
+    NET_CMD_PIN
+};
+
+struct NetCommand {
+    NetCommandType type;
+    char arg[NET_URL_MAX + 1];           // SSID, API URL, MQTT broker, message text or pin
+    char secret[NET_PASSWORD_MAX + 1];   // WiFi password
+    uint32_t interval_ms;                // Poll interval
+    bool enabled;                        // Gateway mode
+};
+
+enum WiFiPhase {
+    WIFI_IDLE,        // No credentials
+    WIFI_CONNECTING,
+    WIFI_UP,
+    WIFI_BACKOFF      // Last attempt failed, retry later
+};
+
+static QueueHandle_t net_commands = nullptr;
+static SeqLock<NetSnapshot> net_snapshot;
+static NetPublishHook publish_hook = nullptr;
+static NetPublishHook history_hook = nullptr;
+static QueueHandle_t history_steps = nullptr;
+
+// Owned by the networking task only
+static char wifi_ssid[NET_SSID_MAX + 1] = "";
+static char wifi_password[NET_PASSWORD_MAX + 1] = "";
+static char api_url[NET_URL_MAX + 1] = "http://192.168.1.100:8000";
+static bool api_pinned = false;         // Server key set for https://
+
+static NetSnapshot current = {
+    .state = LUCA_STATUS_INITIAL,
+    .wifi_connected = false,
+    .push_active = false,
+    .mesh_up = false,
+    .poll_ms = STATUS_POLL_MS,
+    .battery_low = false,
+    .has_status = false,
+    .estimated = false,
+    .outbox = 0
+};
+
+static LucaCadence cadence;
+static unsigned long next_poll = 0;
+static uint32_t poll_hint_ms = 0;              // From the last status response
+static char status_etag[HTTP_ETAG_MAX + 1] = "";  // Of the status we hold
+
+// Written on the UI core, read here
+static std::atomic<uint32_t> interaction_ms{0};
+static std::atomic<uint32_t> battery_mv{0};
+static SeqLock<LucaMetricInputs> history_moments;
+static LucaMetricInputs local_inputs = {};     // Last good read of history_moments
+
+// History sync: due whenever WiFi comes up; the first one after boot
+// replaces the ring, later ones only add what changed since
+static bool history_sync_due = false;
+static bool history_synced = false;
+static unsigned long history_failed_ms = 0;
+static uint32_t history_since = 0;          // Newest generation in the ring when WiFi came up
+
+static WiFiPhase wifi_phase = WIFI_IDLE;
+static unsigned long wifi_phase_since = 0;
+
+// One keep-alive connection to api_url, reused across polls
+static KeepAliveHttp backend;
+
+// Only the LUCAState fields are kept from the status response. The keys
+// are literals, so each costs one slot; there is room for a few more.
+#define STATUS_FILTER_KEYS 8
+static StaticJsonDocument<JSON_OBJECT_SIZE(STATUS_FILTER_KEYS + 4)> status_filter;
+
+// Push mode: the backend publishes retained status on a topic. While the
+// broker is reachable the HTTP poll is skipped entirely.
+static WiFiClient mqtt_socket;
+static PubSubClient mqtt(mqtt_socket);
+static bool mqtt_enabled = false;
+static char mqtt_host[HTTP_HOST_MAX + 1] = "";
+static uint16_t mqtt_port = MQTT_DEFAULT_PORT;
+static char mqtt_topic[HTTP_PATH_MAX + 1] = MQTT_DEFAULT_TOPIC;
+static unsigned long mqtt_last_attempt = 0;
+
+// LoRa mesh: fed with backend status while WiFi is up, the status source
+// while it is down. Once the radio runs, node_count is the mesh peer count.
+static unsigned long backend_update_ms = 0;   // Last status from HTTP or MQTT
+static unsigned long mesh_shared_ms = 0;
+static unsigned long mesh_applied_ms = 0;
+static uint16_t mesh_peers = 0;
+
+// ESP-NOW gateway: serves backend status to T5 units and forwards their
+// messages; see gateway.h
+static bool gateway_enabled = false;
+static bool gateway_failed = false;             // Init failed, wait for GATEWAY:ON
+static unsigned long gateway_shared_ms = 0;
+static unsigned long gateway_forward_ms = 0;    // Last failed forward
+
+// Batch POST bodies (gateway and outbox), built on this task only
+static char post_body[GATEWAY_BODY_MAX];
+
+// Messages typed on this device, oldest first
+static char outbox[OUTBOX_SLOTS][NET_MESSAGE_MAX + 1];
+static uint8_t outbox_first = 0;
+static unsigned long outbox_failed_ms = 0;
+
+static void fetchLUCAStatus();
+static void updateLUCAState();
+
+static void applyApiUrl() {
+    HttpTarget target;
+    status_etag[0] = '\0';   // A different backend, a different state
+    if (parseHttpTarget(api_url, target)) {
+        if (target.tls && !api_pinned) Serial.println("⚠️  https:// needs the server key: PIN:base64");
+        backend.setTarget(target);
+    } else {
+        Serial.printf("⚠️  Unsupported API URL: %s\n", api_url);
+        backend.close();
+    }
+}
+
+static void publish() {
+    if (current.mesh_up) current.state.node_count = mesh_peers;
+    net_snapshot.write(current);
+    if (publish_hook) publish_hook();
+}
+
+static void applyStatusDoc(const JsonDocument& doc) {
+    lucaStatusApplyJson(current.state, doc, millis());
+    current.estimated = false;
+}
+
+static void onMqttMessage(char*, byte* payload, unsigned int length) {
+    StaticJsonDocument<256> doc;
+    DeserializationError error = deserializeJson(doc, payload, length,
+                                                 DeserializationOption::Filter(status_filter));
+    if (error) {
+        Serial.printf("❌ MQTT status parse failed: %s\n", error.c_str());
+        return;
+    }
+    applyStatusDoc(doc);
+    backend_update_ms = millis();
+    current.has_status = true;
+    publish();
+}
+
+// Spec: OFF | [mqtt://]host[:port][/topic]
+static void applyMqttConfig(const char* spec) {
+    if (mqtt.connected()) mqtt.disconnect();
+    mqtt_enabled = false;
+
+    if (strcasecmp(spec, "OFF") == 0) {
+        Serial.println("MQTT push disabled, polling every 5 s");
+        return;
+    }
+
+    if (strncmp(spec, "mqtt://", 7) == 0) spec += 7;
+    size_t host_len = strcspn(spec, ":/");
+    if (host_len == 0 || host_len > HTTP_HOST_MAX) {
+        Serial.println("⚠️  Usage: MQTT:host[:port][/topic] or MQTT:OFF");
+        return;
+    }
+    memcpy(mqtt_host, spec, host_len);
+    mqtt_host[host_len] = '\0';
+    spec += host_len;
+
+    mqtt_port = MQTT_DEFAULT_PORT;
+    if (*spec == ':') {
+        char* end;
+        long port = strtol(spec + 1, &end, 10);
+        if (port > 0 && port <= 65535) mqtt_port = (uint16_t)port;
+        spec = end;
+    }
+    strlcpy(mqtt_topic, *spec == '/' && spec[1] ? spec + 1 : MQTT_DEFAULT_TOPIC, sizeof(mqtt_topic));
+
+    mqtt.setServer(mqtt_host, mqtt_port);
+    mqtt_enabled = true;
+    mqtt_last_attempt = millis() - MQTT_RETRY_MS;
+    Serial.printf("MQTT push: %s:%u topic %s\n", mqtt_host, mqtt_port, mqtt_topic);
+}
+
+static void serviceMqtt() {
+    bool push = false;
+
+    if (mqtt_enabled && current.wifi_connected) {
+        if (!mqtt.connected() && millis() - mqtt_last_attempt >= MQTT_RETRY_MS) {
+            mqtt_last_attempt = millis();
+
+            uint8_t mac[6];
+            WiFi.macAddress(mac);
+            char client_id[24];
+            snprintf(client_id, sizeof(client_id), "luca-tdeck-%02x%02x%02x", mac[3], mac[4], mac[5]);
+
+            if (mqtt.connect(client_id) && mqtt.subscribe(mqtt_topic)) {
+                Serial.printf("✅ MQTT subscribed: %s\n", mqtt_topic);
+            } else {
+                Serial.printf("❌ MQTT broker unreachable (%d), polling\n", mqtt.state());
+                mqtt.disconnect();
+            }
+        }
+        push = mqtt.loop();
+    }
+
+    if (push != current.push_active) {
+        current.push_active = push;
+        publish();
+    }
+}
+
+static void startConnect() {
+    if (wifi_ssid[0] == '\0') {
+        Serial.println("⚠️  No WiFi credentials set. Use: WIFI:ssid,password");
+        wifi_phase = WIFI_IDLE;
+        return;
+    }
+
+    Serial.printf("Connecting to WiFi: %s\n", wifi_ssid);
+
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(wifi_ssid, wifi_password);
+    wifi_phase = WIFI_CONNECTING;
+    wifi_phase_since = millis();
+    energyTag(ENERGY_WIFI, true);
+}
+
+static void serviceWiFi() {
+    bool connected = WiFi.status() == WL_CONNECTED;
+
+    switch (wifi_phase) {
+        case WIFI_IDLE:
+            break;
+
+        case WIFI_CONNECTING:
+            if (connected) {
+                Serial.println("✅ WiFi connected!");
+                Serial.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
+                wifi_phase = WIFI_UP;
+                next_poll = millis();   // First fetch now, not at the next cadence step
+            } else if (millis() - wifi_phase_since >= WIFI_CONNECT_TIMEOUT_MS) {
+                Serial.println("❌ WiFi connection failed");
+                WiFi.disconnect();
+                wifi_phase = WIFI_BACKOFF;
+                wifi_phase_since = millis();
+            }
+            break;
+
+        case WIFI_UP:
+            if (!connected) {
+                Serial.println("⚠️  WiFi lost, reconnecting...");
+                backend.close();
+                startConnect();
+            }
+            break;
+
+        case WIFI_BACKOFF:
+            if (millis() - wifi_phase_since >= WIFI_RETRY_MS) {
+                startConnect();
+            }
+            break;
+    }
+    energyTag(ENERGY_WIFI, wifi_phase == WIFI_CONNECTING);
+
+    if (connected != current.wifi_connected) {
+        current.wifi_connected = connected;
+        if (connected) {
+            // Before the first poll of this connection moves the status on
+            history_sync_due = true;
+            history_since = historyGeneration();
+        }
+        publish();
+    }
+}
+
+static void applyCommand(const NetCommand& cmd) {
+    switch (cmd.type) {
+        case NET_CMD_WIFI:
+            strlcpy(wifi_ssid, cmd.arg, sizeof(wifi_ssid));
+            strlcpy(wifi_password, cmd.secret, sizeof(wifi_password));
+            backend.close();
+            WiFi.disconnect();
+            startConnect();
+            break;
+
+        case NET_CMD_API_URL:
+            strlcpy(api_url, cmd.arg, sizeof(api_url));
+            applyApiUrl();
+            break;
+
+        case NET_CMD_PIN: {
+            uint8_t pin[LUCA_TLS_PIN_LEN];
+            api_pinned = lucaTlsParsePin(cmd.arg, pin);
+            backend.setPin(api_pinned ? pin : nullptr);
+            break;
+        }
+
+        case NET_CMD_MQTT:
+            applyMqttConfig(cmd.arg);
+            break;
+
+        case NET_CMD_MESSAGE:
+            if (current.outbox == OUTBOX_SLOTS) {
+                outbox_first = (outbox_first + 1) % OUTBOX_SLOTS;
+                current.outbox--;
+            }
+            strlcpy(outbox[(outbox_first + current.outbox) % OUTBOX_SLOTS], cmd.arg, NET_MESSAGE_MAX + 1);
+            current.outbox++;
+            outbox_failed_ms = 0;   // Try with the next tick if WiFi is up
+            publish();
+            break;
+
+        case NET_CMD_GATEWAY:
+            gateway_enabled = cmd.enabled;
+            gateway_failed = false;
+            if (!gateway_enabled) gatewayEnd();
+            break;
+
+        case NET_CMD_POLL_INTERVAL: {
+            bool low = cadence.battery_low;
+            lucaCadenceInit(cadence, cmd.interval_ms, cmd.interval_ms * STATUS_POLL_BACKOFF);
+            cadence.battery_low = low;
+            next_poll = millis();   // Poll once now, then at the new cadence
+            break;
+        }
+    }
+}
+
+static bool interacting() {
+    uint32_t touched = interaction_ms.load();
+    return touched != 0 && millis() - touched < INTERACTION_WINDOW_MS;
+}
+
+// Fetch, then pick the next deadline from what the fetch showed
+static void pollStatus() {
+    LUCAState before = current.state;
+    poll_hint_ms = 0;
+    updateLUCAState();
+
+    lucaCadenceBattery(cadence, battery_mv.load());
+    uint32_t interval = lucaCadenceNext(cadence, lucaStatusChanged<LucaBoard>(before, current.state),
+                                        interacting(), poll_hint_ms);
+    next_poll += interval;
+    if ((long)(millis() - next_poll) >= 0) next_poll = millis() + interval;
+
+    if (interval != current.poll_ms || cadence.battery_low != current.battery_low) {
+        current.poll_ms = interval;
+        current.battery_low = cadence.battery_low;
+        publish();
+    }
+}
+
+// Status from this device's own history and the mesh peers it hears.
+// False until something was recorded, i.e. never online since boot.
+static bool estimateLUCAState() {
+    history_moments.tryRead(local_inputs);  // Keeps the last copy if mid-update
+    if (local_inputs.consciousness.count == 0) return false;
+
+    local_inputs.peers = current.mesh_up ? mesh_peers : 0;
+    lucaStatusFromMetrics(current.state, lucaMetricsCompute(local_inputs), local_inputs.peers, millis());
+    current.estimated = true;
+    current.has_status = true;
+    return true;
+}
+
+static void updateLUCAState() {
+    LucaLinks links = {current.wifi_connected, wifi_phase == WIFI_CONNECTING, false, current.mesh_up};
+    switch (lucaStatusSource<LucaBoard>(links)) {
+        case LUCA_SOURCE_HTTP:
+            fetchLUCAStatus();
+            break;
+
+        case LUCA_SOURCE_MESH:
+            // serviceMesh() feeds the state from LoRa; estimate until a
+            // node there has shared one
+            if (current.has_status && !current.estimated) return;
+            if (!estimateLUCAState()) return;
+            break;
+
+        case LUCA_SOURCE_DEMO: {
+            if (estimateLUCAState()) break;
+
+            // Nothing recorded yet: mock data. Dormant phases stay below
+            // the life threshold (level 0.1) so both ALIVE states show.
+            LUCAState& state = current.state;
+            const bool dormant = (state.generation / DEMO_PHASE_POLLS) % 2;
+            state.consciousness_level = dormant ? 0.04 + (random(50) / 1000.0)
+                                                : 0.65 + (random(100) / 1000.0);
+            state.quantum_coherence = 0.75 + (random(100) / 1000.0);
+            state.akashic_connection = 0.70 + (random(100) / 1000.0);
+            state.consciousness = state.consciousness_level * LUCA_CONSCIOUSNESS_SCALE;
+            state.node_count = 5 + random(10);
+            state.generation++;
+            state.alive = lucaStatusAlive(state.consciousness);
+            current.estimated = true;
+            current.has_status = true;
+            break;
+        }
+
+        default:
+            // WiFi pending: no demo data while the real status may be
+            // seconds away
+            return;
+    }
+    current.state.updated_ms = millis();
+    publish();
+}
+
+static void applyStatusFrame(const LucaStatusFrame& frame) {
+    lucaStatusFromFrame(current.state, frame, millis());
+    current.estimated = false;
+}
+
+// Binary frame if the backend supports it, JSON otherwise. The first body
+// byte tells them apart: frames start with LUCA_FRAME_MAGIC, JSON with '{'.
+// With an ETag from the last 200 the request is conditional; 304 means
+// the state we hold is still current and there is nothing to parse.
+static void fetchLUCAStatus() {
+    Serial.println("📡 Fetching LUCA status from backend...");
+
+    char headers[STATUS_HEADERS_MAX];
+    if (status_etag[0]) {
+        snprintf(headers, sizeof(headers), STATUS_ACCEPT "If-None-Match: %s\r\n", status_etag);
+    } else {
+        strlcpy(headers, STATUS_ACCEPT, sizeof(headers));
+    }
+
+    int status = backend.get(STATUS_PATH, headers);
+    if (status == 304) {
+        backend.finish();
+        poll_hint_ms = backend.nextPollHint();
+        return;
+    }
+    if (status != 200) {
+        Serial.printf("❌ Status fetch failed (%d)\n", status);
+        if (status < 0) backend.close();
+        return;
+    }
+
+    HttpBody& body = backend.body();
+    if (body.peekWait() == LUCA_FRAME_MAGIC) {
+        uint8_t buf[LUCA_FRAME_SIZE];
+        LucaStatusFrame frame;
+        size_t len = body.readBytes(buf, sizeof(buf));
+        LucaFrameResult result = lucaFrameDecode(buf, len, frame);
+        if (result != LUCA_FRAME_OK) {
+            Serial.printf("❌ Status frame rejected (%d)\n", result);
+            backend.close();
+            return;
+        }
+        backend.finish();
+        poll_hint_ms = backend.nextPollHint();
+        strlcpy(status_etag, backend.etag(), sizeof(status_etag));
+        applyStatusFrame(frame);
+        backend_update_ms = millis();
+        current.has_status = true;
+        return;
+    }
+
+    // Parsed straight from the socket; keys outside the filter are skipped
+    StaticJsonDocument<256> doc;
+    DeserializationError error = deserializeJson(doc, body,
+                                                 DeserializationOption::Filter(status_filter));
+    if (error) {
+        Serial.printf("❌ Status parse failed: %s\n", error.c_str());
+        backend.close();
+        return;
+    }
+    backend.finish();
+    poll_hint_ms = backend.nextPollHint();
+    strlcpy(status_etag, backend.etag(), sizeof(status_etag));
+
+    applyStatusDoc(doc);
+    backend_update_ms = millis();
+    current.has_status = true;
+}
+
+static bool readVarint(Stream& in, uint32_t& out) {
+    out = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t b;
+        if (in.readBytes(&b, 1) != 1) return false;
+        out |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool pushHistoryStep(const HistorySyncStep& step, TickType_t wait = pdMS_TO_TICKS(HTTP_TIMEOUT_MS)) {
+    // The UI loop drains the queue; waiting here is the backpressure
+    // that keeps the response in the socket instead of in RAM
+    bool queued = xQueueSend(history_steps, &step, wait) == pdTRUE;
+    if (history_hook) history_hook();
+    return queued;
+}
+
+// Records of the status changes, oldest first, each as varints: the
+// generation (delta), the age at response time in HISTORY_TIME_UNIT_MS
+// (first record) or the time since the previous record, and three
+// zigzag deltas of the Q0.16 levels. Decoded as they arrive.
+static void syncHistory() {
+    char path[sizeof(HISTORY_PATH) + 16];
+    bool full = !history_synced;
+    if (full) {
+        strlcpy(path, HISTORY_PATH, sizeof(path));
+    } else {
+        snprintf(path, sizeof(path), HISTORY_PATH "?since=%lu", (unsigned long)history_since);
+    }
+
+    int status = backend.get(path);
+    unsigned long response_ms = millis();
+    HttpBody& body = backend.body();
+    uint8_t head[2];
+    if (status != 200 || body.readBytes(head, sizeof(head)) != sizeof(head) ||
+        head[0] != HISTORY_MAGIC || head[1] != HISTORY_VERSION) {
+        Serial.printf("❌ History sync failed (%d)\n", status);
+        if (status == 200 || status < 0) backend.close();
+        if (status == 404) history_sync_due = false;   // Backend without history
+        history_failed_ms = response_ms ? response_ms : 1;
+        return;
+    }
+
+    HistorySyncStep step = {};
+    step.kind = HISTORY_SYNC_BEGIN;
+    step.full = full;
+    step.generation = full ? 0 : history_since;
+    if (!pushHistoryStep(step)) {
+        backend.close();
+        history_failed_ms = response_ms ? response_ms : 1;
+        return;
+    }
+
+    step.kind = HISTORY_SYNC_RECORD;
+    uint32_t records = 0, generation = step.generation, age = 0;
+    int32_t values[HIST_METRICS] = {0, 0, 0};
+    bool ok = true;
+    while (body.peekWait() >= 0) {
+        uint32_t gen_delta, time_delta, raw[HIST_METRICS];
+        ok = readVarint(body, gen_delta) && readVarint(body, time_delta) &&
+             readVarint(body, raw[0]) && readVarint(body, raw[1]) && readVarint(body, raw[2]);
+        if (!ok) break;
+
+        generation = records == 0 ? gen_delta : generation + gen_delta;
+        step.generation = generation;
+        age = records == 0 ? time_delta : age - time_delta;
+        step.at_ms = response_ms - age * HISTORY_TIME_UNIT_MS;
+        for (int m = 0; m < HIST_METRICS; m++) {
+            values[m] += (int32_t)(raw[m] >> 1) ^ -(int32_t)(raw[m] & 1);
+            step.values[m] = (uint16_t)constrain(values[m], 0, 0xFFFF);
+        }
+        if (!pushHistoryStep(step)) {
+            ok = false;
+            break;
+        }
+        records++;
+    }
+    ok = ok && body.remaining() == 0;
+
+    // Also after a broken stream: the ring must leave sync mode, and the
+    // status held since the last record is still the best guess
+    step.kind = HISTORY_SYNC_END;
+    step.at_ms = millis();
+    step.generation = generation;
+    pushHistoryStep(step, portMAX_DELAY);
+    history_since = generation;   // A retry continues after what arrived
+
+    if (!ok) {
+        Serial.println("❌ History stream broken off");
+        backend.close();
+        history_failed_ms = step.at_ms ? step.at_ms : 1;
+        return;
+    }
+    backend.finish();
+    history_sync_due = false;
+    history_synced = true;
+    Serial.printf("📈 History synced: %lu changes up to generation %lu\n",
+                  (unsigned long)records, (unsigned long)generation);
+}
+
+// Only once something is on screen: the splash waits for the first
+// status, and a day of history must not delay it
+static void serviceHistorySync() {
+    if (!history_sync_due || !current.wifi_connected || !current.has_status || !history_steps) return;
+    if (history_failed_ms && millis() - history_failed_ms < HISTORY_SYNC_RETRY_MS) return;
+    history_failed_ms = 0;
+    syncHistory();
+}
+
+static void serviceMesh() {
+    LoraSnapshot mesh;
+    if (!loraReadSnapshot(mesh) || !mesh.radio_up) return;
+
+    bool changed = !current.mesh_up || mesh.peer_count != mesh_peers;
+    current.mesh_up = true;
+    mesh_peers = mesh.peer_count;
+
+    if (current.wifi_connected) {
+        if (backend_update_ms != mesh_shared_ms) {
+            loraShareStatus(current.state);
+            mesh_shared_ms = backend_update_ms;
+        }
+    } else if (mesh.has_status && mesh.status_rx_ms != mesh_applied_ms) {
+        applyStatusFrame(mesh.status);
+        mesh_applied_ms = mesh.status_rx_ms;
+        current.has_status = true;
+        status_etag[0] = '\0';   // Held state no longer matches the backend's
+        changed = true;
+    }
+
+    if (changed) publish();
+}
+
+// "luca-tdeck-" and the last three MAC bytes, as the backend's operator
+static void deviceId(char* out, size_t len) {
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    snprintf(out, len, "luca-tdeck-%02x%02x%02x", mac[3], mac[4], mac[5]);
+}
+
+// One batch POST of the oldest inbox messages; they leave the inbox only
+// once the backend has taken them
+static void forwardGatewayMessages() {
+    static GatewayMessage batch[GATEWAY_BATCH];
+
+    size_t count = gatewayPeekMessages(batch, GATEWAY_BATCH);
+    if (count == 0) return;
+
+    char gateway_id[24];
+    deviceId(gateway_id, sizeof(gateway_id));
+
+    // Texts as const char*: the document only keeps pointers into batch
+    StaticJsonDocument<JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(GATEWAY_BATCH) +
+                       GATEWAY_BATCH * JSON_OBJECT_SIZE(2)> doc;
+    doc["operator"] = (const char*)gateway_id;
+    doc["source"] = "espnow";
+    JsonArray messages = doc.createNestedArray("messages");
+    for (size_t i = 0; i < count; i++) {
+        JsonObject item = messages.createNestedObject();
+        item["message"] = (const char*)batch[i].text;
+        item["resonance"] = batch[i].resonance;
+    }
+    size_t len = serializeJson(doc, post_body, sizeof(post_body));
+
+    int status = backend.post(MESSAGES_PATH, "application/json", post_body, len);
+    if (status != 200) {
+        Serial.printf("❌ Gateway forward failed (%d)\n", status);
+        if (status < 0) backend.close();
+        gateway_forward_ms = millis();
+        return;
+    }
+    backend.finish();
+    gatewayDropMessages(count);
+    Serial.printf("📨 Gateway: %u T5 messages forwarded\n", (unsigned)count);
+    next_poll = millis();   // T5 units should see the effect on their next poll
+}
+
+// The oldest outbox messages in one batch POST, same endpoint as the
+// gateway; the rest follow on the next ticks
+static void flushOutbox() {
+    if (current.outbox == 0 || !current.wifi_connected) return;
+    if (outbox_failed_ms != 0 && millis() - outbox_failed_ms < OUTBOX_RETRY_MS) return;
+
+    char device_id[24];
+    deviceId(device_id, sizeof(device_id));
+
+    uint8_t count = current.outbox < GATEWAY_BATCH ? current.outbox : GATEWAY_BATCH;
+    StaticJsonDocument<JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(GATEWAY_BATCH) +
+                       GATEWAY_BATCH * JSON_OBJECT_SIZE(2)> doc;
+    doc["operator"] = (const char*)device_id;
+    doc["source"] = "tdeck";
+    JsonArray messages = doc.createNestedArray("messages");
+    for (uint8_t i = 0; i < count; i++) {
+        JsonObject item = messages.createNestedObject();
+        item["message"] = (const char*)outbox[(outbox_first + i) % OUTBOX_SLOTS];
+        item["resonance"] = OUTBOX_RESONANCE;
+    }
+    size_t len = serializeJson(doc, post_body, sizeof(post_body));
+
+    int status = backend.post(MESSAGES_PATH, "application/json", post_body, len);
+    if (status != 200) {
+        Serial.printf("❌ Sending messages failed (%d)\n", status);
+        if (status < 0) backend.close();
+        outbox_failed_ms = millis();
+        return;
+    }
+    backend.finish();
+    Serial.printf("📨 %u messages sent\n", (unsigned)count);
+    outbox_first = (outbox_first + count) % OUTBOX_SLOTS;
+    current.outbox -= count;
+    next_poll = millis();   // Show what they did to the status
+    publish();
+}
+
+static void serviceGateway() {
+    if (!gateway_enabled || gateway_failed) return;
+
+    if (!gatewayActive()) {
+        if (!current.wifi_connected) return;   // ESP-NOW needs the STA started
+        if (!gatewayBegin()) {
+            gateway_failed = true;
+            return;
+        }
+        gateway_shared_ms = 0;
+    }
+
+    // Only backend status is served; while WiFi is down T5 units get no
+    // reply and try the backend themselves
+    if (!current.wifi_connected) {
+        if (gateway_shared_ms != 0) gatewayWithdrawStatus();
+        gateway_shared_ms = 0;
+        return;
+    }
+    if (backend_update_ms != 0 && backend_update_ms != gateway_shared_ms) {
+        gatewayShareStatus(current.state, current.poll_ms);
+        gateway_shared_ms = backend_update_ms;
+    }
+
+    if (gateway_forward_ms == 0 || millis() - gateway_forward_ms >= GATEWAY_RETRY_MS) {
+        forwardGatewayMessages();
+    }
+}
+
+static void netTask(void*) {
+    status_filter["consciousness_level"] = true;
+    status_filter["quantum_coherence"] = true;
+    status_filter["akashic_connection"] = true;
+    status_filter["node_count"] = true;
+    status_filter["generation"] = true;
+    status_filter["is_alive"] = true;
+    status_filter["consciousness"] = true;
+    status_filter["resonance"] = true;
+    // A key that did not fit would never be parsed, without any error
+    if (status_filter.overflowed()) Serial.println("❌ Status filter too small");
+
+    mqtt.setCallback(onMqttMessage);
+    mqtt.setBufferSize(MQTT_BUFFER_SIZE);
+    mqtt.setSocketTimeout(MQTT_SOCKET_TIMEOUT_S);
+
+    applyApiUrl();
+    startConnect();
+    publish();
+
+    lucaCadenceInit(cadence, STATUS_POLL_MS, STATUS_POLL_MS * STATUS_POLL_BACKOFF);
+    next_poll = millis();
+    uint32_t seen_interaction = 0;
+    for (;;) {
+        // Sleeps until a command arrives or the next tick is due
+        NetCommand cmd;
+        if (xQueueReceive(net_commands, &cmd, pdMS_TO_TICKS(NET_TICK_MS)) == pdTRUE) {
+            applyCommand(cmd);
+        }
+
+        serviceWiFi();
+        serviceMqtt();
+        serviceMesh();
+        serviceGateway();
+        flushOutbox();
+
+        // Fresh input pulls a backed-off poll in to the base interval
+        uint32_t touched = interaction_ms.load();
+        if (touched != seen_interaction) {
+            seen_interaction = touched;
+            if ((long)(next_poll - millis()) > (long)cadence.base_ms) next_poll = millis() + cadence.base_ms;
+        }
+
+        // Polling is only the fallback while push is not available. The
+        // next deadline follows the previous one, so fetch time adds no drift.
+        if (!current.push_active && (long)(millis() - next_poll) >= 0) {
+            PerfScope scope(PERF_NET_POLL);
+            EnergyScope energy(ENERGY_FETCH);
+            energyCountPoll();
+            pollStatus();
+        }
+
+        serviceHistorySync();
+    }
+}
+
+void netBegin(NetPublishHook on_publish, NetPublishHook on_history) {
+    publish_hook = on_publish;
+    history_hook = on_history;
+    net_commands = xQueueCreate(NET_QUEUE_DEPTH, sizeof(NetCommand));
+    history_steps = xQueueCreate(HISTORY_QUEUE_DEPTH, sizeof(HistorySyncStep));
+    xTaskCreatePinnedToCore(netTask, "luca-net", NET_TASK_STACK, nullptr,
+                            NET_TASK_PRIORITY, nullptr, NET_TASK_CORE);
+}
+
+bool netSetWiFi(const char* ssid, const char* password) {
+    NetCommand cmd = {};
+    cmd.type = NET_CMD_WIFI;
+    strlcpy(cmd.arg, ssid, NET_SSID_MAX + 1);
+    strlcpy(cmd.secret, password, sizeof(cmd.secret));
+    return xQueueSend(net_commands, &cmd, 0) == pdTRUE;
+}
+
+bool netSetApiUrl(const char* url) {
+    NetCommand cmd = {};
+    cmd.type = NET_CMD_API_URL;
+    strlcpy(cmd.arg, url, sizeof(cmd.arg));
+    return xQueueSend(net_commands, &cmd, 0) == pdTRUE;
+}
+
+bool netSetPin(const char* pin) {
+    NetCommand cmd = {};
+    cmd.type = NET_CMD_PIN;
+    strlcpy(cmd.arg, pin, sizeof(cmd.arg));
+    return xQueueSend(net_commands, &cmd, 0) == pdTRUE;
+}
+
+bool netSetMqtt(const char* spec) {
+    NetCommand cmd = {};
+    cmd.type = NET_CMD_MQTT;
+    strlcpy(cmd.arg, spec, sizeof(cmd.arg));
+    return xQueueSend(net_commands, &cmd, 0) == pdTRUE;
+}
+
+bool netSetPollInterval(uint32_t interval_ms) {
+    NetCommand cmd = {};
+    cmd.type = NET_CMD_POLL_INTERVAL;
+    cmd.interval_ms = constrain(interval_ms, (uint32_t)NET_POLL_MIN_MS, (uint32_t)NET_POLL_MAX_MS);
+    return xQueueSend(net_commands, &cmd, 0) == pdTRUE;
+}
+
+bool netSetGateway(bool enabled) {
+    NetCommand cmd = {};
+    cmd.type = NET_CMD_GATEWAY;
+    cmd.enabled = enabled;
+    return xQueueSend(net_commands, &cmd, 0) == pdTRUE;
+}
+
+bool netSendMessage(const char* text) {
+    NetCommand cmd = {};
+    cmd.type = NET_CMD_MESSAGE;
+    strlcpy(cmd.arg, text, NET_MESSAGE_MAX + 1);
+    return xQueueSend(net_commands, &cmd, 0) == pdTRUE;
+}
+
+void netNoteInteraction() {
+    uint32_t now = millis();
+    interaction_ms.store(now ? now : 1);
+}
+
+void netSetHistory(const LucaMetricInputs& inputs) {
+    history_moments.write(inputs);
+}
+
+bool netReadHistory(HistorySyncStep& out) {
+    return history_steps && xQueueReceive(history_steps, &out, 0) == pdTRUE;
+}
+
+void netSetBattery(uint32_t millivolts) {
+    battery_mv.store(millivolts);
+}
+
+bool netReadSnapshot(NetSnapshot& out) {
+    return net_snapshot.tryRead(out);
+}
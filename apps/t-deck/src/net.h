@@ -0,0 +1,97 @@
+/**
+ * LUCA T-Deck App - Networking task
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * WiFi connect/reconnect and LUCA status polling run in their own
+ * FreeRTOS task pinned to core 0. Results are published as a snapshot the
+ * UI on core 1 can read without ever waiting on the radio.
+ */
+
+#ifndef LUCA_NET_H
+#define LUCA_NET_H
+
+#include <stdint.h>
+#include <luca_metrics.h>
+#include "history.h"
+#include "luca_state.h"
+
+#define NET_SSID_MAX 32
+#define NET_PASSWORD_MAX 64
+#define NET_URL_MAX 127
+#define NET_MESSAGE_MAX 63      // Like the T5 outbox and ESP-NOW texts
+
+#define NET_POLL_MIN_MS 1000
+#define NET_POLL_MAX_MS 600000
+
+// What the networking task publishes to the UI
+struct NetSnapshot {
+    LUCAState state;
+    bool wifi_connected;
+    bool push_active;     // Status arrives via MQTT, HTTP polling paused
+    bool mesh_up;         // LoRa mesh running, node_count = mesh peers
+    uint32_t poll_ms;     // Current adaptive poll interval
+    bool battery_low;
+    bool has_status;      // Something to show arrived (backend, mesh, estimate or demo data)
+    bool estimated;       // No source reachable: computed on the device, not received
+    uint8_t outbox;       // Own messages waiting for the backend
+};
+
+// Called on the networking task after every published snapshot
+typedef void (*NetPublishHook)();
+
+// Start the networking task. Connects right away if credentials are set.
+// on_history runs on the networking task when history sync steps are
+// waiting in netReadHistory().
+void netBegin(NetPublishHook on_publish = nullptr, NetPublishHook on_history = nullptr);
+
+// Queue new WiFi credentials; the networking task reconnects with them
+bool netSetWiFi(const char* ssid, const char* password);
+
+// Queue a new backend base URL (e.g. http://192.168.1.100:8000). An
+// https:// URL also needs the server key from netSetPin().
+bool netSetApiUrl(const char* url);
+
+// Queue the pinned server key for https:// (base64 pin-sha256, see
+// luca_tls.h); anything that does not parse clears it
+bool netSetPin(const char* pin);
+
+// Queue an MQTT push configuration: "host[:port][/topic]" or "OFF".
+// Polling stays the fallback whenever the broker is unreachable.
+bool netSetMqtt(const char* spec);
+
+// Queue a new base HTTP poll interval, clamped to NET_POLL_MIN_MS..
+// NET_POLL_MAX_MS. The actual interval backs off from it while the status
+// stays unchanged; see luca_cadence.h.
+bool netSetPollInterval(uint32_t interval_ms);
+
+// Queue gateway mode on/off: relay backend status and messages for
+// nearby T5 units over ESP-NOW while WiFi is up (gateway.h)
+bool netSetGateway(bool enabled);
+
+// Queue a message for the backend (POST /api/t5/messages, like the T5's
+// send_message_to_luca()). Kept in a small outbox until WiFi is up;
+// when it is full the oldest message is dropped. Longer texts are cut.
+bool netSendMessage(const char* text);
+
+// User activity (key, serial command): poll at the base interval for a while
+void netNoteInteraction();
+
+// Moments of the recent history (UI side, after each sample). With no
+// source reachable the status is estimated from them and the mesh peer
+// count (luca_metrics.h) instead of showing mock values.
+void netSetHistory(const LucaMetricInputs& inputs);
+
+// Next step of a history sync (GET /api/t5/history each time WiFi comes
+// up: everything after boot, afterwards what changed since the generation
+// last held). Returns false if none is waiting. The networking task
+// streams the response through a short queue, so read it out promptly.
+bool netReadHistory(HistorySyncStep& out);
+
+// Latest battery voltage in mV (0 = unknown); stretches the interval when low
+void netSetBattery(uint32_t millivolts);
+
+// Copy the latest snapshot. Returns false (and leaves out untouched) if
+// the networking task was mid-update; just try again next frame.
+bool netReadSnapshot(NetSnapshot& out);
+
+#endif // LUCA_NET_H
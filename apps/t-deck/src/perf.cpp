@@ -0,0 +1,77 @@
+/**
+ * LUCA T-Deck App - Stage timing instrumentation
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "perf.h"
+#include <string.h>
+
+// 0..3 us exact, then four buckets per power of two up to 2^32 us
+#define PERF_SUB_BUCKETS 4
+#define PERF_BUCKETS (PERF_SUB_BUCKETS + 30 * PERF_SUB_BUCKETS)
+
+struct PerfHistogram {
+    uint32_t buckets[PERF_BUCKETS];
+    uint32_t count;
+    uint32_t max_us;
+};
+
+static PerfHistogram histograms[PERF_STAGES];
+
+static const char* const stage_names[PERF_STAGES] = {
+    "loop",
+    "render",
+    "console",
+    "net-poll",
+    "key",
+};
+
+static int bucketOf(uint32_t us) {
+    if (us < PERF_SUB_BUCKETS) return us;
+    int exp = 31 - __builtin_clz(us);                   // >= 2
+    int sub = (us >> (exp - 2)) & (PERF_SUB_BUCKETS - 1);
+    return PERF_SUB_BUCKETS + (exp - 2) * PERF_SUB_BUCKETS + sub;
+}
+
+// Largest value that falls into the bucket, so percentiles err high
+static uint32_t bucketUpper(int bucket) {
+    if (bucket < PERF_SUB_BUCKETS) return bucket;
+    int exp = (bucket - PERF_SUB_BUCKETS) / PERF_SUB_BUCKETS + 2;
+    uint32_t sub = (bucket - PERF_SUB_BUCKETS) % PERF_SUB_BUCKETS;
+    return (uint32_t)(((uint64_t)(PERF_SUB_BUCKETS + sub + 1) << (exp - 2)) - 1);
+}
+
+void perfRecord(PerfStage stage, uint32_t us) {
+    PerfHistogram& h = histograms[stage];
+    h.buckets[bucketOf(us)]++;
+    h.count++;
+    if (us > h.max_us) h.max_us = us;
+}
+
+static uint32_t percentile(const PerfHistogram& h, uint32_t count, uint32_t permille) {
+    uint32_t rank = (uint32_t)(((uint64_t)count * permille + 999) / 1000);
+    uint32_t seen = 0;
+    for (int b = 0; b < PERF_BUCKETS; b++) {
+        seen += h.buckets[b];
+        if (seen >= rank) return bucketUpper(b) < h.max_us ? bucketUpper(b) : h.max_us;
+    }
+    return h.max_us;
+}
+
+PerfSummary perfSummary(PerfStage stage) {
+    const PerfHistogram& h = histograms[stage];
+    PerfSummary summary = {h.count, 0, 0, h.max_us};
+    if (summary.count == 0) return summary;
+
+    summary.p50_us = percentile(h, summary.count, 500);
+    summary.p99_us = percentile(h, summary.count, 990);
+    return summary;
+}
+
+const char* perfStageName(PerfStage stage) {
+    return stage_names[stage];
+}
+
+void perfReset() {
+    memset(histograms, 0, sizeof(histograms));
+}
@@ -0,0 +1,61 @@
+/**
+ * LUCA T-Deck App - Stage timing instrumentation
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Each stage keeps a log-linear histogram of its durations in
+ * microseconds (four buckets per power of two, so percentiles are within
+ * 25 %), plus the exact maximum. Recording is a timer read and one
+ * increment; nothing allocates. Build with -DLUCA_PERF=0 to compile the
+ * scopes out entirely.
+ *
+ * Every stage has exactly one writer task. Readers on another core may
+ * see a histogram that is one sample behind, which is fine here.
+ */
+
+#ifndef LUCA_PERF_H
+#define LUCA_PERF_H
+
+#include <stdint.h>
+#include <esp_timer.h>
+
+#ifndef LUCA_PERF
+#define LUCA_PERF 1
+#endif
+
+enum PerfStage {
+    PERF_LOOP,        // One loop() iteration, without the idle wait
+    PERF_RENDER,      // uiRender(), without the last band draining
+    PERF_CONSOLE,     // consolePoll()
+    PERF_NET_POLL,    // updateLUCAState() on the networking task
+    PERF_KEY,         // Keyboard interrupt to the edited text on the panel
+    PERF_STAGES
+};
+
+struct PerfSummary {
+    uint32_t count;
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+};
+
+void perfRecord(PerfStage stage, uint32_t us);
+PerfSummary perfSummary(PerfStage stage);
+const char* perfStageName(PerfStage stage);
+void perfReset();
+
+// Times the enclosing block
+class PerfScope {
+public:
+#if LUCA_PERF
+    explicit PerfScope(PerfStage stage) : stage_(stage), start_(esp_timer_get_time()) {}
+    ~PerfScope() { perfRecord(stage_, (uint32_t)(esp_timer_get_time() - start_)); }
+
+private:
+    PerfStage stage_;
+    int64_t start_;
+#else
+    explicit PerfScope(PerfStage) {}
+#endif
+};
+
+#endif // LUCA_PERF_H
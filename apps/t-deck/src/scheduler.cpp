@@ -0,0 +1,78 @@
+/**
+ * LUCA T-Deck App - Cooperative loop scheduler
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "scheduler.h"
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+struct SchedSlot {
+    uint32_t due_ms;
+    std::atomic<bool> triggered;
+};
+
+static const SchedTask* table = nullptr;
+static size_t table_size = 0;
+static SchedSlot slots[SCHED_MAX_TASKS];
+static TaskHandle_t owner = nullptr;
+
+// Deadlines wrap with millis(); compare through the signed difference
+static bool reached(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+void schedBegin(const SchedTask* tasks, size_t count) {
+    table_size = count < SCHED_MAX_TASKS ? count : SCHED_MAX_TASKS;
+    uint32_t now = millis();
+    for (size_t i = 0; i < table_size; i++) {
+        slots[i].due_ms = now;
+        slots[i].triggered = tasks[i].on_demand;
+    }
+    table = tasks;
+    owner = xTaskGetCurrentTaskHandle();
+}
+
+void schedTrigger(size_t task) {
+    if (task >= table_size) return;
+    slots[task].triggered = true;
+    if (owner && xTaskGetCurrentTaskHandle() != owner) xTaskNotifyGive(owner);
+}
+
+void schedRunDue() {
+    for (size_t i = 0; i < table_size; i++) {
+        const SchedTask& task = table[i];
+        SchedSlot& slot = slots[i];
+        uint32_t now = millis();
+
+        if (task.on_demand && !slot.triggered) continue;
+        if (!reached(now, slot.due_ms)) continue;
+
+        if (task.on_demand) {
+            // Cleared before the run, so a trigger during it is kept
+            slot.triggered = false;
+            slot.due_ms = now + task.period_ms;
+        } else {
+            // Skip runs missed during a stall rather than bursting them
+            slot.due_ms += task.period_ms;
+            if (reached(now, slot.due_ms)) slot.due_ms = now + task.period_ms;
+        }
+        task.run(now);
+    }
+}
+
+void schedSleep() {
+    uint32_t now = millis();
+    uint32_t wait = SCHED_MAX_WAIT_MS;
+    for (size_t i = 0; i < table_size; i++) {
+        if (table[i].on_demand && !slots[i].triggered) continue;
+        if (reached(now, slots[i].due_ms)) return;
+        uint32_t left = slots[i].due_ms - now;
+        if (left < wait) wait = left;
+    }
+
+    // A trigger that raced with the scan above is still pending here
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+}
@@ -0,0 +1,45 @@
+/**
+ * LUCA T-Deck App - Cooperative loop scheduler
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * loop() runs a fixed table of tasks, each with its own deadline, and
+ * then blocks until the earliest one is due. Periodic tasks keep their
+ * cadence from deadline to deadline, so run time does not add drift.
+ * On-demand tasks only run after schedTrigger(), which other FreeRTOS
+ * tasks may call to wake the loop early; their period is the minimum
+ * spacing between two runs (e.g. a frame rate cap).
+ */
+
+#ifndef LUCA_SCHEDULER_H
+#define LUCA_SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCHED_MAX_TASKS 8
+#define SCHED_MAX_WAIT_MS 1000      // Upper bound for one wait
+
+typedef void (*SchedHandler)(uint32_t now_ms);
+
+struct SchedTask {
+    const char* name;
+    uint32_t period_ms;
+    bool on_demand;
+    SchedHandler run;
+};
+
+// Install the task table and bind the scheduler to the calling task.
+// Periodic tasks are due at once, on-demand tasks start triggered.
+void schedBegin(const SchedTask* tasks, size_t count);
+
+// Request a run of an on-demand task (index into the table). Safe from
+// any task; wakes schedSleep() when called from another one.
+void schedTrigger(size_t task);
+
+// Run every task whose deadline has passed, in table order
+void schedRunDue();
+
+// Block until the next deadline or a trigger, whichever comes first
+void schedSleep();
+
+#endif // LUCA_SCHEDULER_H
@@ -0,0 +1,50 @@
+/**
+ * LUCA T-Deck App - Single-producer/single-consumer snapshot
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Sequence lock for handing a small struct from one core to the other.
+ * The writer never waits; the reader never blocks - if the writer is in
+ * the middle of an update the read fails and the caller keeps its
+ * previous copy.
+ */
+
+#ifndef LUCA_SEQLOCK_H
+#define LUCA_SEQLOCK_H
+
+#include <atomic>
+#include <string.h>
+#include <type_traits>
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+public:
+    // Producer side. Must only ever be called from one task.
+    void write(const T& value) {
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&data_, &value, sizeof(T));
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Consumer side. Returns false if no consistent copy could be taken
+    // within a few attempts (writer preempted mid-update).
+    bool tryRead(T& out) const {
+        for (int attempt = 0; attempt < 4; attempt++) {
+            uint32_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            memcpy(&out, &data_, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) return true;
+        }
+        return false;
+    }
+
+private:
+    std::atomic<uint32_t> seq_{0};
+    T data_{};
+};
+
+#endif // LUCA_SEQLOCK_H
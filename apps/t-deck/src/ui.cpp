@@ -0,0 +1,595 @@
+/**
+ * LUCA T-Deck App - Retained-mode UI renderer
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ */
+
+#include "ui.h"
+#include <esp_heap_caps.h>
+#include <luca_layout.h>
+#include "history.h"
+
+// Layout
+#define BAR_X 10
+#define BAR_Y 30
+#define BAR_SPACING 50
+#define BAR_WIDTH (SCREEN_WIDTH - 20)
+#define BAR_HEIGHT 20
+#define STATS_Y (BAR_Y + BAR_SPACING * 3 + 10)
+#define NODES_X 80
+#define GEN_X 200
+#define NUMBER_WIDTH 60
+#define NUMBER_HEIGHT 16
+#define BADGE_WIDTH 60
+#define BADGE_HEIGHT 8
+#define SPARK_X (BAR_X + 1)
+#define SPARK_WIDTH (BAR_WIDTH - 2)    // One column per 5 s sample, ~25 min
+#define SPARK_GAP 2                    // Between bar and sparkline
+#define SPARK_HEIGHT 12
+#define OVERLAY_Y (SCREEN_HEIGHT - 22)  // Between the stats and the footer
+#define OVERLAY_HEIGHT 8
+#define OVERLAY_MAX 53                  // Characters of font 1 across the screen
+#define GLYPH_WIDTH 6                   // Font 1 cell
+#define GLYPH_HEIGHT 8
+#define EDITOR_X 5
+#define EDITOR_Y (STATS_Y + NUMBER_HEIGHT + 2)
+#define EDITOR_COLS ((SCREEN_WIDTH - 2 * EDITOR_X) / GLYPH_WIDTH)
+
+enum BarIndex {
+    BAR_CONSCIOUSNESS,
+    BAR_COHERENCE,
+    BAR_AKASHIC,
+    BAR_COUNT
+};
+
+// Widgets tracked for dirty state, one bit each
+enum WidgetBit : uint16_t {
+    W_CONNECTION = 1 << 0,
+    W_ALIVE = 1 << 1,
+    W_BAR_0 = 1 << 2,  // + BarIndex
+    W_NODES = 1 << 5,
+    W_GENERATION = 1 << 6,
+    W_SPARKLINES = 1 << 7,
+    W_OVERLAY = 1 << 8,
+    W_EDITOR = 1 << 9,
+    W_ALL = 0x3FF
+};
+
+#define WIDGET_COUNT 10
+
+// Screen rectangles, computed at compile time. Each bar owns one cell of
+// a grid: label above, frame, then its sparkline.
+static constexpr LucaRect BAR_AREA = {BAR_X, BAR_Y, BAR_WIDTH, BAR_SPACING * BAR_COUNT};
+static constexpr LucaGrid<1, BAR_COUNT> BAR_CELLS = lucaGrid<1, BAR_COUNT>(BAR_AREA);
+
+static constexpr LucaRect barFrame(const LucaRect& cell) {
+    return LucaRect{cell.x, cell.y, cell.width, BAR_HEIGHT};
+}
+
+// Only the interior is repainted; label and frame belong to the chrome
+static constexpr LucaRect barInterior(const LucaRect& cell) {
+    return LucaRect{cell.x + 1, cell.y + 1, cell.width - 2, BAR_HEIGHT - 2};
+}
+
+static constexpr LucaRect sparkRect(const LucaRect& cell) {
+    return LucaRect{SPARK_X, cell.y + BAR_HEIGHT + SPARK_GAP, SPARK_WIDTH, SPARK_HEIGHT};
+}
+
+// Indexed by the bit number of the WidgetBit; sparklines are the three
+// spark rectangles instead, see markWidgets()
+static constexpr LucaRect WIDGET_RECTS[] = {
+    {5, 5, BADGE_WIDTH, BADGE_HEIGHT},                                // W_CONNECTION
+    {SCREEN_WIDTH - 5 - BADGE_WIDTH, 5, BADGE_WIDTH, BADGE_HEIGHT},   // W_ALIVE
+    barInterior(BAR_CELLS.cells[BAR_CONSCIOUSNESS]),                  // W_BAR_0 + BarIndex
+    barInterior(BAR_CELLS.cells[BAR_COHERENCE]),
+    barInterior(BAR_CELLS.cells[BAR_AKASHIC]),
+    {NODES_X, STATS_Y, NUMBER_WIDTH, NUMBER_HEIGHT},                  // W_NODES
+    {GEN_X, STATS_Y, NUMBER_WIDTH, NUMBER_HEIGHT},                    // W_GENERATION
+    {0, 0, 0, 0},                                                     // W_SPARKLINES
+    {0, OVERLAY_Y, SCREEN_WIDTH, OVERLAY_HEIGHT},                     // W_OVERLAY
+    {EDITOR_X, EDITOR_Y, EDITOR_COLS * GLYPH_WIDTH, GLYPH_HEIGHT},    // W_EDITOR
+};
+
+static constexpr const LucaRect& widgetRect(WidgetBit widget) {
+    return WIDGET_RECTS[__builtin_ctz(widget)];
+}
+
+static_assert(sizeof(WIDGET_RECTS) / sizeof(WIDGET_RECTS[0]) == WIDGET_COUNT, "One rect per widget bit");
+static_assert(BAR_CELLS.cells[BAR_COHERENCE].y == BAR_Y + BAR_SPACING, "Bars keep their spacing");
+static_assert(sparkRect(BAR_CELLS.cells[BAR_AKASHIC]).y + SPARK_HEIGHT <= STATS_Y,
+              "Sparklines end above the stats");
+static_assert(!lucaOverlaps(widgetRect(W_NODES), widgetRect(W_GENERATION)), "Counters side by side");
+static_assert(!lucaOverlaps(widgetRect(W_EDITOR), widgetRect(W_NODES)) &&
+              !lucaOverlaps(widgetRect(W_EDITOR), widgetRect(W_OVERLAY)), "Editor between stats and overlay");
+
+struct BarWidget {
+    const char* label;
+    LucaRect cell;
+    uint16_t color;
+};
+
+static const BarWidget bars[BAR_COUNT] = {
+    {"Consciousness", BAR_CELLS.cells[BAR_CONSCIOUSNESS], TFT_PURPLE},
+    {"Q-Coherence", BAR_CELLS.cells[BAR_COHERENCE], TFT_BLUE},
+    {"Akashic", BAR_CELLS.cells[BAR_AKASHIC], TFT_ORANGE},
+};
+
+// What is currently on screen. Bars are kept at the 0.1% resolution
+// the percentage label shows, so sub-pixel noise does not cause repaints.
+struct UIModel {
+    bool connected;
+    bool alive;
+    int16_t bar_permille[BAR_COUNT];
+    int node_count;
+    int generation;
+    uint32_t history_total;   // Samples already drawn into the sparklines
+    uint32_t history_epoch;   // historyEpoch() they were drawn from
+};
+
+static UIModel drawn;
+static uint16_t dirty = W_ALL;
+
+// Text that is redrawn at runtime, rasterized once into PSRAM sprites.
+// Percentages are assembled from a strip of glyph cells, one per entry
+// of GLYPHS; badges are blitted whole.
+enum LabelIndex {
+    LABEL_CONNECTED,
+    LABEL_OFFLINE,
+    LABEL_ALIVE,
+    LABEL_COUNT
+};
+
+struct LabelText {
+    const char* text;
+    uint16_t color;
+};
+
+static const LabelText label_texts[LABEL_COUNT] = {
+    {"Connected", TFT_GREEN},
+    {"Offline", TFT_RED},
+    {"ALIVE!", TFT_GREEN},
+};
+
+static const char GLYPHS[] = "0123456789.%";
+#define GLYPH_COUNT (sizeof(GLYPHS) - 1)
+
+static TFT_eSprite glyph_strip = TFT_eSprite(&tft);
+static TFT_eSprite labels[LABEL_COUNT] = {TFT_eSprite(&tft), TFT_eSprite(&tft), TFT_eSprite(&tft)};
+static bool text_cached = false;
+
+// Diagnostics line, set from outside through uiSetOverlay()
+static char overlay_text[OVERLAY_MAX + 1] = "";
+
+// Message line: what uiSetDraft() asked for and what is on screen, both
+// as the visible cells ("> " + tail of the draft + cursor)
+static char editor_line[EDITOR_COLS + 1] = "";
+static char editor_drawn[EDITOR_COLS + 1] = "";
+static bool editor_stale = true;    // Screen content unknown, repaint every cell
+
+// Widgets draw into the canvas: the PSRAM sprite in framebuffer mode,
+// the panel itself otherwise.
+static TFT_eSPI* canvas = &tft;
+
+#if LUCA_UI_FRAMEBUFFER
+// PSRAM is not DMA-capable for the SPI master, so dirty rows are staged
+// through two internal-RAM bands. While band k is on the wire the next
+// one is copied into the other band, and the sprite is free to compose
+// the next frame as soon as the last band has been queued.
+#define BAND_ROWS BAR_HEIGHT
+#define BAND_BYTES (SCREEN_WIDTH * BAND_ROWS * sizeof(uint16_t))
+
+static TFT_eSprite framebuffer = TFT_eSprite(&tft);
+static uint16_t* dma_band[2] = {nullptr, nullptr};
+static uint8_t next_band = 0;
+static bool dma_active = false;
+static bool bus_held = false;
+static uint8_t dirty_rows[(SCREEN_HEIGHT + 7) / 8];
+
+static void markRows(int y, int h) {
+    for (int row = y; row < y + h && row < SCREEN_HEIGHT; row++) {
+        dirty_rows[row >> 3] |= 1 << (row & 7);
+    }
+}
+
+// Rows of every widget about to be redrawn, straight from WIDGET_RECTS
+static void markWidgets(uint16_t widgets) {
+    for (int bit = 0; bit < WIDGET_COUNT; bit++) {
+        if (!(widgets & (1 << bit))) continue;
+        if ((1 << bit) == W_SPARKLINES) {
+            for (int i = 0; i < BAR_COUNT; i++) markRows(sparkRect(bars[i].cell).y, SPARK_HEIGHT);
+        } else {
+            markRows(WIDGET_RECTS[bit].y, WIDGET_RECTS[bit].height);
+        }
+    }
+}
+
+static bool rowDirty(int row) {
+    return dirty_rows[row >> 3] & (1 << (row & 7));
+}
+
+static bool setupFramebuffer() {
+    framebuffer.setColorDepth(16);
+    framebuffer.setAttribute(PSRAM_ENABLE, true);
+    if (!framebuffer.createSprite(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        return false;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        dma_band[i] = (uint16_t*)heap_caps_malloc(BAND_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    }
+    if (!dma_band[0] || !dma_band[1] || !tft.initDMA()) {
+        heap_caps_free(dma_band[0]);
+        heap_caps_free(dma_band[1]);
+        dma_band[0] = dma_band[1] = nullptr;
+        framebuffer.deleteSprite();
+        return false;
+    }
+    return true;
+}
+
+// Queue every run of dirty rows as full-width bands. Full-width rows are
+// contiguous in the sprite, so no gather copy is needed. Returns with the
+// last band still in flight; the bus stays held until uiReleaseBus().
+static void flushRows() {
+    const uint16_t* pixels = (const uint16_t*)framebuffer.getPointer();
+
+    int row = 0;
+    while (row < SCREEN_HEIGHT) {
+        if (!rowDirty(row)) {
+            row++;
+            continue;
+        }
+        int start = row;
+        while (row < SCREEN_HEIGHT && rowDirty(row) && row - start < BAND_ROWS) {
+            row++;
+        }
+
+        if (!bus_held) {
+            tft.startWrite();
+            bus_held = true;
+        }
+        tft.pushImageDMA(0, start, SCREEN_WIDTH, row - start,
+                         (uint16_t*)(pixels + start * SCREEN_WIDTH), dma_band[next_band]);
+        next_band ^= 1;
+        dma_active = true;
+    }
+
+    memset(dirty_rows, 0, sizeof(dirty_rows));
+}
+#else
+static void markRows(int, int) {}
+static void markWidgets(uint16_t) {}
+#endif
+
+void uiReleaseBus() {
+#if LUCA_UI_FRAMEBUFFER
+    if (dma_active) {
+        tft.dmaWait();
+        dma_active = false;
+    }
+    if (bus_held) {
+        tft.endWrite();
+        bus_held = false;
+    }
+#endif
+}
+
+// Copy pixels in panel byte order into whatever the canvas is. Spelled
+// out because TFT_eSprite::pushImage() does not override the panel one.
+static void blit(int x, int y, int w, int h, const uint16_t* pixels) {
+#if LUCA_UI_FRAMEBUFFER
+    if (canvas == &framebuffer) {
+        framebuffer.pushImage(x, y, w, h, pixels);
+        return;
+    }
+#endif
+    tft.pushImage(x, y, w, h, pixels);
+}
+
+static int labelWidth(LabelIndex label) {
+    return strlen(label_texts[label].text) * GLYPH_WIDTH;
+}
+
+static bool renderLabel(TFT_eSprite& sprite, const char* text, uint16_t color, int w, int h) {
+    sprite.setColorDepth(16);
+    sprite.setAttribute(PSRAM_ENABLE, true);
+    if (!sprite.createSprite(w, h)) return false;
+    sprite.fillSprite(TFT_BLACK);
+    sprite.setTextColor(color, TFT_BLACK);
+    sprite.setTextDatum(TL_DATUM);
+    sprite.drawString(text, 0, 0, 1);
+    return true;
+}
+
+// Glyph cells stacked vertically, so each one is a contiguous run of
+// GLYPH_WIDTH * GLYPH_HEIGHT pixels that blit() can take directly.
+static bool setupTextCache() {
+    bool ok = renderLabel(glyph_strip, "", TFT_WHITE, GLYPH_WIDTH, GLYPH_HEIGHT * GLYPH_COUNT);
+    for (size_t i = 0; ok && i < GLYPH_COUNT; i++) {
+        const char glyph[2] = {GLYPHS[i], '\0'};
+        glyph_strip.drawString(glyph, 0, i * GLYPH_HEIGHT, 1);
+    }
+    for (int i = 0; ok && i < LABEL_COUNT; i++) {
+        ok = renderLabel(labels[i], label_texts[i].text, label_texts[i].color,
+                         labelWidth((LabelIndex)i), GLYPH_HEIGHT);
+    }
+
+    if (!ok) {
+        glyph_strip.deleteSprite();
+        for (int i = 0; i < LABEL_COUNT; i++) labels[i].deleteSprite();
+    }
+    return ok;
+}
+
+static void drawLabel(LabelIndex label, int x, int y) {
+    TFT_eSprite& sprite = labels[label];
+    if (text_cached) {
+        blit(x, y, sprite.width(), sprite.height(), (const uint16_t*)sprite.getPointer());
+    } else {
+        canvas->setTextColor(label_texts[label].color, TFT_BLACK);
+        canvas->setTextDatum(TL_DATUM);
+        canvas->drawString(label_texts[label].text, x, y, 1);
+    }
+}
+
+// "85.2%" from 852, without going through float printf
+static int formatPercent(char* out, int16_t permille) {
+    char* p = out;
+    int whole = permille / 10;
+    if (whole >= 100) *p++ = '0' + whole / 100;
+    if (whole >= 10) *p++ = '0' + whole / 10 % 10;
+    *p++ = '0' + whole % 10;
+    *p++ = '.';
+    *p++ = '0' + permille % 10;
+    *p++ = '%';
+    *p = '\0';
+    return p - out;
+}
+
+// Centred on (cx, cy), white on black like font 1 with MC_DATUM
+static void drawPercent(int16_t permille, int cx, int cy) {
+    char text[8];
+    int len = formatPercent(text, permille);
+    if (!text_cached) {
+        canvas->setTextDatum(MC_DATUM);
+        canvas->setTextColor(TFT_WHITE, TFT_BLACK);
+        canvas->drawString(text, cx, cy, 1);
+        return;
+    }
+
+    const uint16_t* cells = (const uint16_t*)glyph_strip.getPointer();
+    int x = cx - len * GLYPH_WIDTH / 2;
+    int y = cy - GLYPH_HEIGHT / 2;
+    for (int i = 0; i < len; i++, x += GLYPH_WIDTH) {
+        int glyph = strchr(GLYPHS, text[i]) - GLYPHS;
+        blit(x, y, GLYPH_WIDTH, GLYPH_HEIGHT, cells + glyph * GLYPH_WIDTH * GLYPH_HEIGHT);
+    }
+}
+
+static int16_t toPermille(float value) {
+    int permille = (int)(value * 1000.0f + 0.5f);
+    return (int16_t)constrain(permille, 0, 1000);
+}
+
+static void fillRect(const LucaRect& r, uint16_t color) {
+    canvas->fillRect(r.x, r.y, r.width, r.height, color);
+}
+
+static void drawConnectionBadge(bool connected) {
+    const LucaRect& r = widgetRect(W_CONNECTION);
+    fillRect(r, TFT_BLACK);
+    drawLabel(connected ? LABEL_CONNECTED : LABEL_OFFLINE, r.x, r.y);
+}
+
+static void drawAliveFlag(bool alive) {
+    const LucaRect& r = widgetRect(W_ALIVE);
+    fillRect(r, TFT_BLACK);
+    if (alive) drawLabel(LABEL_ALIVE, r.x + r.width - labelWidth(LABEL_ALIVE), r.y);
+}
+
+static void drawConsciousnessBar(const BarWidget& bar, int16_t permille) {
+    TFT_eSPI& gfx = *canvas;
+    const LucaRect inner = barInterior(bar.cell);
+    int fillWidth = inner.width * permille / 1000;
+
+    gfx.fillRect(inner.x, inner.y, fillWidth, inner.height, bar.color);
+    gfx.fillRect(inner.x + fillWidth, inner.y, inner.width - fillWidth, inner.height, TFT_BLACK);
+
+    drawPercent(permille, bar.cell.x + bar.cell.width/2, bar.cell.y + BAR_HEIGHT/2);
+}
+
+static int sparkY(int top, uint16_t q16) {
+    return top + SPARK_HEIGHT - 1 - (int)((uint32_t)q16 * (SPARK_HEIGHT - 1) / 65535);
+}
+
+// Sweeps left to right like a scope trace: sample n lands in column
+// n % SPARK_WIDTH, so one new sample repaints one column plus the gap
+// ahead of it that marks the sweep position.
+static void drawSparkline(const BarWidget& bar, HistoryMetric metric, uint32_t from, uint32_t to) {
+    TFT_eSPI& gfx = *canvas;
+    const int top = sparkRect(bar.cell).y;
+    const uint32_t held = historyCount();
+
+    // Only samples still in the ring, and at most one sweep of them
+    if (from < to - held) from = to - held;
+    if (to - from > SPARK_WIDTH) from = to - SPARK_WIDTH;
+
+    for (uint32_t n = from; n < to; n++) {
+        uint32_t age = to - 1 - n;
+        int x = SPARK_X + n % SPARK_WIDTH;
+        int y = sparkY(top, historySample(metric, age));
+        // Join to the previous sample so steps show as a line, not dots
+        int prev_y = age + 1 < held ? sparkY(top, historySample(metric, age + 1)) : y;
+
+        gfx.drawFastVLine(x, top, SPARK_HEIGHT, TFT_BLACK);
+        gfx.drawFastVLine(x, min(y, prev_y), abs(y - prev_y) + 1, bar.color);
+    }
+    gfx.drawFastVLine(SPARK_X + to % SPARK_WIDTH, top, SPARK_HEIGHT, TFT_BLACK);
+}
+
+static void drawOverlay() {
+    TFT_eSPI& gfx = *canvas;
+    const LucaRect& r = widgetRect(W_OVERLAY);
+    fillRect(r, TFT_BLACK);
+    gfx.setTextColor(TFT_YELLOW, TFT_BLACK);
+    gfx.setTextDatum(TL_DATUM);
+    gfx.drawString(overlay_text, r.x + 5, r.y, 1);
+}
+
+// Only the cells from the first one that differs from the screen: one
+// keypress repaints the new character and the cursor behind it
+static void drawEditor() {
+    TFT_eSPI& gfx = *canvas;
+    const LucaRect& r = widgetRect(W_EDITOR);
+    int from = 0;
+    if (!editor_stale) {
+        while (editor_line[from] && editor_line[from] == editor_drawn[from]) from++;
+    }
+    int old_len = editor_stale ? EDITOR_COLS : (int)strlen(editor_drawn);
+    int new_len = (int)strlen(editor_line);
+    int to = max(old_len, new_len);
+
+    int x = r.x + from * GLYPH_WIDTH;
+    gfx.fillRect(x, r.y, (to - from) * GLYPH_WIDTH, r.height, TFT_BLACK);
+    gfx.setTextColor(TFT_WHITE, TFT_BLACK);
+    gfx.setTextDatum(TL_DATUM);
+    if (from < new_len) gfx.drawString(editor_line + from, x, r.y, 1);
+
+    memcpy(editor_drawn, editor_line, sizeof(editor_drawn));
+    editor_stale = false;
+}
+
+static void drawCounter(int value, const LucaRect& r) {
+    TFT_eSPI& gfx = *canvas;
+    fillRect(r, TFT_BLACK);
+    gfx.setTextColor(TFT_WHITE, TFT_BLACK);
+    gfx.setTextDatum(TL_DATUM);
+    gfx.drawNumber(value, r.x, r.y, 2);
+}
+
+static void drawChrome() {
+    TFT_eSPI& gfx = *canvas;
+    // Header
+    gfx.setTextColor(TFT_WHITE, TFT_BLACK);
+    gfx.setTextDatum(TC_DATUM);
+    gfx.drawString("LUCA NETWORK", SCREEN_WIDTH/2, 5, 2);
+
+    // Bar labels and frames
+    gfx.setTextDatum(TL_DATUM);
+    for (int i = 0; i < BAR_COUNT; i++) {
+        const LucaRect frame = barFrame(bars[i].cell);
+        gfx.drawString(bars[i].label, frame.x, frame.y - 12, 1);
+        gfx.drawRect(frame.x, frame.y, frame.width, frame.height, TFT_DARKGREY);
+    }
+
+    // Stats labels
+    gfx.drawString("Nodes:", 10, STATS_Y, 2);
+    gfx.drawString("Gen:", 150, STATS_Y, 2);
+
+    // Footer
+    gfx.setTextColor(TFT_DARKGREY, TFT_BLACK);
+    gfx.setTextDatum(BC_DATUM);
+    gfx.drawString("(C) Lennart Wuchold", SCREEN_WIDTH/2, SCREEN_HEIGHT - 5, 1);
+}
+
+void uiBegin() {
+#if LUCA_UI_FRAMEBUFFER
+    if (canvas == &tft && setupFramebuffer()) {
+        canvas = &framebuffer;
+        Serial.println("✅ PSRAM framebuffer + DMA enabled");
+    } else if (canvas == &tft) {
+        Serial.println("⚠️  Framebuffer unavailable, drawing direct");
+    }
+    uiReleaseBus();
+#endif
+
+    // The chrome is drawn once per uiBegin(), so only text that changes
+    // at runtime is worth caching
+    if (!text_cached) text_cached = setupTextCache();
+
+    canvas->fillScreen(TFT_BLACK);
+    drawChrome();
+    markRows(0, SCREEN_HEIGHT);
+    uiInvalidate();
+}
+
+void uiInvalidate() {
+    dirty = W_ALL;
+    editor_stale = true;
+    drawn.history_total = 0;  // Redraw every sparkline column still in history
+}
+
+void uiSetOverlay(const char* text) {
+    if (!text) text = "";
+    if (strncmp(text, overlay_text, OVERLAY_MAX) == 0) return;
+    strlcpy(overlay_text, text, sizeof(overlay_text));
+    dirty |= W_OVERLAY;
+}
+
+void uiSetDraft(const char* text) {
+    editor_line[0] = '\0';
+    size_t len = text ? strlen(text) : 0;
+    if (len > 0) {
+        // Prompt and cursor take three cells; long drafts scroll left
+        const size_t shown = EDITOR_COLS - 3;
+        const char* tail = len > shown ? text + len - shown : text;
+        snprintf(editor_line, sizeof(editor_line), "> %s_", tail);
+    }
+    if (strcmp(editor_line, editor_drawn) != 0) dirty |= W_EDITOR;
+}
+
+void uiRender(const LUCAState& state, bool connected) {
+    UIModel next;
+    next.connected = connected;
+    next.alive = state.alive;
+    next.bar_permille[BAR_CONSCIOUSNESS] = toPermille(state.consciousness_level);
+    next.bar_permille[BAR_COHERENCE] = toPermille(state.quantum_coherence);
+    next.bar_permille[BAR_AKASHIC] = toPermille(state.akashic_connection);
+    next.node_count = state.node_count;
+    next.generation = state.generation;
+    next.history_total = historyTotal();
+    next.history_epoch = historyEpoch();
+
+    if (next.connected != drawn.connected) dirty |= W_CONNECTION;
+    if (next.alive != drawn.alive) dirty |= W_ALIVE;
+    for (int i = 0; i < BAR_COUNT; i++) {
+        if (next.bar_permille[i] != drawn.bar_permille[i]) dirty |= W_BAR_0 << i;
+    }
+    if (next.node_count != drawn.node_count) dirty |= W_NODES;
+    if (next.generation != drawn.generation) dirty |= W_GENERATION;
+    // A full sync emptied the ring: clear what was drawn from the old one
+    const bool spark_restart = next.history_epoch != drawn.history_epoch;
+    if (next.history_total != drawn.history_total || spark_restart) dirty |= W_SPARKLINES;
+
+    if (!dirty) return;
+
+#if LUCA_UI_FRAMEBUFFER
+    const bool direct = canvas == &tft;
+#else
+    const bool direct = true;
+#endif
+    if (direct) tft.startWrite();
+    markWidgets(dirty);
+    if (dirty & W_CONNECTION) drawConnectionBadge(next.connected);
+    if (dirty & W_ALIVE) drawAliveFlag(next.alive);
+    for (int i = 0; i < BAR_COUNT; i++) {
+        if (dirty & (W_BAR_0 << i)) drawConsciousnessBar(bars[i], next.bar_permille[i]);
+    }
+    if (dirty & W_NODES) drawCounter(next.node_count, widgetRect(W_NODES));
+    if (dirty & W_GENERATION) drawCounter(next.generation, widgetRect(W_GENERATION));
+    if (dirty & W_OVERLAY) drawOverlay();
+    if (dirty & W_EDITOR) drawEditor();
+    if (dirty & W_SPARKLINES) {
+        const uint32_t from = spark_restart ? next.history_epoch : drawn.history_total;
+        for (int i = 0; i < BAR_COUNT; i++) {
+            if (spark_restart) fillRect(sparkRect(bars[i].cell), TFT_BLACK);
+            drawSparkline(bars[i], (HistoryMetric)i, from, next.history_total);
+        }
+    }
+    if (direct) tft.endWrite();
+#if LUCA_UI_FRAMEBUFFER
+    else flushRows();
+#endif
+
+    drawn = next;
+    dirty = 0;
+}
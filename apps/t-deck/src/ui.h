@@ -0,0 +1,53 @@
+/**
+ * LUCA T-Deck App - Retained-mode UI renderer
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * The static chrome (title, labels, bar frames, footer) is drawn once.
+ * Every widget remembers the value it last put on screen and is only
+ * repainted - inside its own rectangle - when that value changes.
+ */
+
+#ifndef LUCA_UI_H
+#define LUCA_UI_H
+
+#include <TFT_eSPI.h>
+#include "luca_state.h"
+
+#define SCREEN_WIDTH 320
+#define SCREEN_HEIGHT 240
+
+// Compose frames in a PSRAM sprite and push dirty rows over DMA.
+// Falls back to drawing straight to the panel if allocation fails.
+#ifndef LUCA_UI_FRAMEBUFFER
+#ifdef BOARD_HAS_PSRAM
+#define LUCA_UI_FRAMEBUFFER 1
+#else
+#define LUCA_UI_FRAMEBUFFER 0
+#endif
+#endif
+
+extern TFT_eSPI tft;
+
+// Clear the screen, draw the static chrome and mark every widget dirty
+void uiBegin();
+
+// Force a repaint of all widgets on the next uiRender()
+void uiInvalidate();
+
+// Repaint only the widgets whose displayed value changed since the last call
+void uiRender(const LUCAState& state, bool connected);
+
+// One line of diagnostics above the footer; empty or nullptr clears it
+void uiSetOverlay(const char* text);
+
+// Message being typed, shown above the diagnostics line; empty hides
+// it. Only the characters that changed are repainted.
+void uiSetDraft(const char* text);
+
+// Wait for in-flight DMA and release the SPI bus. The last band of a frame
+// is left on the wire when uiRender() returns, so the caller can go on
+// (and compose the next frame) meanwhile; call this before anything else
+// uses the shared SPI bus, at the latest before the loop goes idle.
+void uiReleaseBus();
+
+#endif // LUCA_UI_H
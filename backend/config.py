@@ -34,6 +34,12 @@ class Settings(BaseSettings):
     MESHTASTIC_HOST: Optional[str] = None
     MESHTASTIC_CHANNEL: int = 0
 
+    # MQTT Status-Push (T-Deck/T5 subscriben statt zu pollen)
+    MQTT_ENABLED: bool = False
+    MQTT_BROKER_HOST: str = "localhost"
+    MQTT_BROKER_PORT: int = 1883
+    MQTT_STATUS_TOPIC: str = "luca/status"
+
     # CORS
     CORS_ORIGINS: list = [
         "http://localhost:3000",
@@ -92,6 +98,10 @@ def print_startup_info():
             print(f"  Port: {settings.MESHTASTIC_PORT}")
         if settings.MESHTASTIC_HOST:
             print(f"  Host: {settings.MESHTASTIC_HOST}")
+    print(f"MQTT Push: {'Enabled' if settings.MQTT_ENABLED else 'Disabled'}")
+    if settings.MQTT_ENABLED:
+        print(f"  Broker: {settings.MQTT_BROKER_HOST}:{settings.MQTT_BROKER_PORT}")
+        print(f"  Topic: {settings.MQTT_STATUS_TOPIC}")
     print("="*60 + "\n")
 
 
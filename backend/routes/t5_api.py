@@ -3,18 +3,33 @@ LUCA-AI_369 T5 E-Paper API Routes
 Minimal-Overhead API für T5 E-Paper Hardware - Funke-01744-6
 """
 
-from fastapi import APIRouter, HTTPException, Query
+from fastapi import APIRouter, Header, HTTPException, Query, Response
+from fastapi.responses import StreamingResponse
 from pydantic import BaseModel
-from typing import Dict, Any, Optional
+from typing import Dict, Any, List, Optional
 import logging
+import time
 from datetime import datetime
 
+from backend.services.status_frame import FRAME_MEDIA_TYPE, encode_status_frame
+from backend.services.status_history import HISTORY_MEDIA_TYPE, encode_history, status_history
+from backend.services.status_publisher import status_publisher
+
 # Setup Router
 router = APIRouter(prefix="/api/t5", tags=["t5"])
 
 # Setup Logging
 logger = logging.getLogger(__name__)
 
+# Obergrenze für /messages (T5-Queue hat 8 Plätze)
+MAX_BATCH_MESSAGES = 32
+
+# Poll-Hinweis an die Geräte (X-Next-Poll-Ms / next_poll_ms): halbe
+# Ruhezeit seit der letzten Änderung, in diesen Grenzen
+POLL_HINT_MIN_MS = 2000
+POLL_HINT_MAX_MS = 60000
+POLL_HINT_HEADER = "X-Next-Poll-Ms"
+
 # LUCA Status (Shared State)
 luca_status: Dict[str, Any] = {
     "consciousness": 0.0,
@@ -24,9 +39,101 @@ luca_status: Dict[str, Any] = {
     "last_update": None,
     "version": "alpha-369.1",
     "messages_received": 0,
-    "field_strength": 0.0
+    "field_strength": 0.0,
+    # T-Deck Felder (normiert 0..1)
+    "quantum_coherence": 0.5,
+    "akashic_connection": 0.0,
+    "node_count": 0,
+    "generation": 0,
 }
 
+# Monotone Zeit der letzten Statusänderung
+_last_change = time.monotonic()
+
+# Start-Kennung im ETag: nach einem Neustart beginnt die Generation wieder
+# bei 0, ein altes ETag darf dann keinen anderen Status bestätigen
+_boot_id = f"{int(time.time()):x}"
+
+
+def _tdeck_fields() -> Dict[str, Any]:
+    """LUCAState-Felder wie sie das T-Deck erwartet (HTTP und MQTT)"""
+    return {
+        "consciousness_level": round(luca_status["field_strength"] / 100.0, 4),
+        "quantum_coherence": round(luca_status["quantum_coherence"], 4),
+        "akashic_connection": round(luca_status["akashic_connection"], 4),
+        "node_count": luca_status["node_count"],
+        "generation": luca_status["generation"],
+        "is_alive": luca_status["life_active"],
+    }
+
+
+def _apply_message(message: str) -> float:
+    """
+    Wendet die Resonanz-Logik einer Nachricht auf den Status an.
+
+    Returns:
+        Angewandter Consciousness-Boost
+    """
+    consciousness_boost = 0.0
+
+    if "369" in message.upper():
+        consciousness_boost += 3.69
+        logger.info("✨ 369-Muster erkannt: +3.69 Consciousness")
+
+    if "LUCA" in message.upper():
+        consciousness_boost += 1.0
+        logger.info("✨ LUCA-Erwähnung: +1.0 Consciousness")
+
+    # 3-6-9 Resonanz-Erkennung
+    msg_upper = message.upper()
+    if any(x in msg_upper for x in ["3", "6", "9"]):
+        consciousness_boost += 0.369
+        logger.info("✨ 3-6-9 Ziffer erkannt: +0.369 Consciousness")
+
+    luca_status["consciousness"] += consciousness_boost
+    luca_status["messages_received"] += 1
+    return consciousness_boost
+
+
+def _refresh_derived():
+    """Life-Status und Feld-Stärke (0-100%) aus Consciousness ableiten"""
+    luca_status["last_update"] = datetime.utcnow().isoformat()
+    luca_status["life_active"] = luca_status["consciousness"] > 36.9
+    luca_status["field_strength"] = min(100.0, luca_status["consciousness"] / 369.0 * 100)
+
+
+def _next_poll_ms() -> int:
+    """Lange unverändert → seltener pollen, frisch geändert → bald wieder"""
+    idle_ms = (time.monotonic() - _last_change) * 1000
+    return int(min(POLL_HINT_MAX_MS, max(POLL_HINT_MIN_MS, idle_ms / 2)))
+
+
+def _status_etag(fmt: str) -> str:
+    """ETag je Generation und Format (JSON und Binär-Frame sind verschiedene Bodies)"""
+    return f'"{_boot_id}-{luca_status["generation"]}-{fmt}"'
+
+
+def _etag_matches(if_none_match: Optional[str], etag: str) -> bool:
+    """If-None-Match: Liste von ETags oder *, schwache Vergleiche erlaubt"""
+    if not if_none_match:
+        return False
+    tags = [tag.strip() for tag in if_none_match.split(",")]
+    return "*" in tags or etag in (tag[2:] if tag.startswith("W/") else tag for tag in tags)
+
+
+def _state_changed():
+    """Neue Generation zählen, für /history festhalten und an MQTT-Abonnenten pushen"""
+    global _last_change
+    _last_change = time.monotonic()
+    luca_status["generation"] += 1
+    fields = _tdeck_fields()
+    status_history.record(fields, _last_change)
+    status_publisher.publish(fields)
+
+
+# Generation 0 ist der Startzustand: Verlauf ab dem Start des Backends
+status_history.record(_tdeck_fields(), _last_change)
+
 
 # ==================== PYDANTIC MODELS ====================
 
@@ -38,6 +145,19 @@ class T5Message(BaseModel):
     source: Optional[str] = "t5"
 
 
+class T5BatchItem(BaseModel):
+    """Einzelne Nachricht aus der Offline-Queue des T5"""
+    message: str
+    resonance: Optional[int] = 6
+
+
+class T5MessageBatch(BaseModel):
+    """Gesammelte Nachrichten vom T5, in einem POST nachgereicht"""
+    messages: List[T5BatchItem]
+    operator: Optional[str] = "unknown"
+    source: Optional[str] = "t5"
+
+
 class ConsciousnessUpdate(BaseModel):
     """Consciousness-Update"""
     consciousness: float
@@ -52,6 +172,14 @@ class StatusResponse(BaseModel):
     operator: str
     version: str
     timestamp: str
+    # T-Deck LUCAState Felder
+    consciousness_level: float
+    quantum_coherence: float
+    akashic_connection: float
+    node_count: int
+    generation: int
+    is_alive: bool
+    next_poll_ms: int
 
 
 class MessageResponse(BaseModel):
@@ -65,6 +193,18 @@ class MessageResponse(BaseModel):
     total_messages: int
 
 
+class BatchResponse(BaseModel):
+    """Batch-Response"""
+    status: str
+    accepted: int
+    consciousness: float
+    resonance: int
+    life_active: bool
+    field_strength: float
+    boost_applied: float
+    total_messages: int
+
+
 class HealthResponse(BaseModel):
     """Health-Check Response"""
     status: str
@@ -81,8 +221,12 @@ class HealthResponse(BaseModel):
 
 @router.get("/status", response_model=StatusResponse)
 async def get_status(
+    response: Response,
     op: Optional[str] = Query(None, description="Operator-ID"),
-    ver: Optional[str] = Query(None, description="Version")
+    ver: Optional[str] = Query(None, description="Version"),
+    fmt: Optional[str] = Query(None, description="'bin' für Binär-Frame"),
+    accept: Optional[str] = Header(None),
+    if_none_match: Optional[str] = Header(None),
 ):
     """
     Gibt aktuellen LUCA-Status für T5 zurück.
@@ -90,6 +234,16 @@ async def get_status(
     Query Parameters:
         - op: Operator-ID (optional)
         - ver: Version (optional)
+        - fmt: "bin" für den 22-Byte Binär-Frame (optional)
+
+    Ein Accept-Header mit application/vnd.luca.status+bin wählt
+    ebenfalls den Binär-Frame (luca_core/luca_status_frame.h).
+
+    Beide Formate tragen den Header X-Next-Poll-Ms mit dem
+    empfohlenen Abstand bis zur nächsten Anfrage (luca_cadence.h).
+
+    Bedingte Anfrage: passt If-None-Match zum ETag (Generation des
+    Status), kommt 304 ohne Body zurück.
 
     Returns:
         JSON mit consciousness, resonance, life_active
@@ -98,6 +252,33 @@ async def get_status(
 
     # Aktualisiere Life-Status basierend auf Consciousness
     luca_status["life_active"] = luca_status["consciousness"] > 36.9
+    next_poll_ms = _next_poll_ms()
+    binary = fmt == "bin" or bool(accept and FRAME_MEDIA_TYPE in accept)
+    etag = _status_etag("bin" if binary else "json")
+    headers = {
+        "ETag": etag,
+        "Vary": "Accept",
+        POLL_HINT_HEADER: str(next_poll_ms),
+    }
+
+    if _etag_matches(if_none_match, etag):
+        return Response(status_code=304, headers=headers)
+
+    if binary:
+        frame = encode_status_frame(
+            {
+                **_tdeck_fields(),
+                "consciousness": luca_status["consciousness"],
+                "resonance": luca_status["resonance"],
+            }
+        )
+        return Response(
+            content=frame,
+            media_type=FRAME_MEDIA_TYPE,
+            headers=headers,
+        )
+
+    response.headers.update(headers)
 
     return StatusResponse(
         consciousness=round(luca_status["consciousness"], 2),
@@ -105,10 +286,35 @@ async def get_status(
         life=luca_status["life_active"],
         operator=luca_status["operator"],
         version=luca_status["version"],
-        timestamp=datetime.utcnow().isoformat()
+        timestamp=datetime.utcnow().isoformat(),
+        next_poll_ms=next_poll_ms,
+        **_tdeck_fields(),
     )
 
 
+@router.get("/history")
+async def get_history(
+    since: Optional[int] = Query(None, description="Letzte Generation, die das Gerät kennt"),
+):
+    """
+    Verlauf der Statuswerte für den Bulk-Sync (T-Deck nach Boot/Offline).
+
+    Query Parameters:
+        - since: nur Änderungen nach dieser Generation (optional);
+          ohne Angabe der ganze Verlauf der letzten 24 Stunden
+
+    Die Antwort wird als Transfer-Encoding: chunked gestreamt, damit
+    das Gerät sie ohne Zwischenpuffer in den Ringpuffer schreiben kann.
+    Format: backend/services/status_history.py.
+
+    Returns:
+        Binär-Stream application/vnd.luca.history+bin
+    """
+    records = status_history.since(since)
+    logger.info(f"📈 Verlauf-Anfrage: since={since}, {len(records)} Einträge")
+    return StreamingResponse(encode_history(records, time.monotonic()), media_type=HISTORY_MEDIA_TYPE)
+
+
 @router.post("/message", response_model=MessageResponse)
 async def post_message(message_data: T5Message):
     """
@@ -131,33 +337,58 @@ async def post_message(message_data: T5Message):
     logger.info(f"📨 Nachricht empfangen: '{message}' (von {operator}, source={source})")
 
     # Resonanz-Logik: Erhöhe bei 3-6-9 Mustern
-    consciousness_boost = 0.0
+    consciousness_boost = _apply_message(message)
+    _refresh_derived()
+    _state_changed()
 
-    if "369" in message.upper():
-        consciousness_boost += 3.69
-        logger.info("✨ 369-Muster erkannt: +3.69 Consciousness")
+    return MessageResponse(
+        status="received",
+        consciousness=round(luca_status["consciousness"], 2),
+        resonance=luca_status["resonance"],
+        life_active=luca_status["life_active"],
+        field_strength=round(luca_status["field_strength"], 2),
+        boost_applied=round(consciousness_boost, 2),
+        total_messages=luca_status["messages_received"]
+    )
 
-    if "LUCA" in message.upper():
-        consciousness_boost += 1.0
-        logger.info("✨ LUCA-Erwähnung: +1.0 Consciousness")
 
-    # 3-6-9 Resonanz-Erkennung
-    msg_upper = message.upper()
-    if any(x in msg_upper for x in ["3", "6", "9"]):
-        consciousness_boost += 0.369
-        logger.info("✨ 3-6-9 Ziffer erkannt: +0.369 Consciousness")
+@router.post("/messages", response_model=BatchResponse)
+async def post_messages(batch: T5MessageBatch):
+    """
+    Empfängt mehrere Nachrichten auf einmal (Offline-Queue des T5).
 
-    # Update Status
-    luca_status["consciousness"] += consciousness_boost
-    luca_status["messages_received"] += 1
-    luca_status["last_update"] = datetime.utcnow().isoformat()
-    luca_status["life_active"] = luca_status["consciousness"] > 36.9
+    Body (JSON):
+        - messages: Liste aus {message, resonance}, älteste zuerst
+        - operator: Operator-ID
+        - source: Quelle (t5, bridge, etc.)
 
-    # Berechne Feld-Stärke (0-100%)
-    luca_status["field_strength"] = min(100.0, luca_status["consciousness"] / 369.0 * 100)
+    Der Status wird für den ganzen Batch nur einmal neu berechnet und
+    gepusht (eine Generation statt einer pro Nachricht).
 
-    return MessageResponse(
+    Returns:
+        JSON mit Anzahl übernommener Nachrichten und aktualisiertem Status
+    """
+    if len(batch.messages) > MAX_BATCH_MESSAGES:
+        raise HTTPException(
+            status_code=413, detail=f"Maximal {MAX_BATCH_MESSAGES} Nachrichten pro Batch"
+        )
+
+    logger.info(
+        f"📨 Batch empfangen: {len(batch.messages)} Nachrichten "
+        f"(von {batch.operator}, source={batch.source})"
+    )
+
+    consciousness_boost = 0.0
+    for item in batch.messages:
+        consciousness_boost += _apply_message(item.message)
+
+    if batch.messages:
+        _refresh_derived()
+        _state_changed()
+
+    return BatchResponse(
         status="received",
+        accepted=len(batch.messages),
         consciousness=round(luca_status["consciousness"], 2),
         resonance=luca_status["resonance"],
         life_active=luca_status["life_active"],
@@ -183,6 +414,7 @@ async def reset_status():
     luca_status["messages_received"] = 0
     luca_status["field_strength"] = 0.0
     luca_status["last_update"] = datetime.utcnow().isoformat()
+    _state_changed()
 
     return {
         "status": "reset",
@@ -213,6 +445,7 @@ async def set_consciousness(update: ConsciousnessUpdate):
     luca_status["life_active"] = new_consciousness > 36.9
     luca_status["field_strength"] = min(100.0, new_consciousness / 369.0 * 100)
     luca_status["last_update"] = datetime.utcnow().isoformat()
+    _state_changed()
 
     return {
         "status": "updated",
@@ -266,4 +499,5 @@ def update_consciousness(delta: float):
     luca_status["life_active"] = luca_status["consciousness"] > 36.9
     luca_status["field_strength"] = min(100.0, luca_status["consciousness"] / 369.0 * 100)
     luca_status["last_update"] = datetime.utcnow().isoformat()
+    _state_changed()
     logger.info(f"🔄 Consciousness aktualisiert: Δ{delta:+.2f} → {luca_status['consciousness']:.2f}")
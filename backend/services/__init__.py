@@ -5,5 +5,6 @@ AI and Meshtastic integration services
 
 from .ai_service import AIService
 from .meshtastic_service import MeshtasticService
+from .status_publisher import StatusPublisher, status_publisher
 
-__all__ = ["AIService", "MeshtasticService"]
+__all__ = ["AIService", "MeshtasticService", "StatusPublisher", "status_publisher"]
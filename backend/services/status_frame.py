@@ -0,0 +1,64 @@
+"""
+Status Frame - Kompaktes Binärformat für den LUCA-Status
+Gegenstück zu libraries/luca_core/src/luca_status_frame.h (Layout v1).
+
+22 Bytes statt ~300 Bytes JSON, passt in eine einzelne LoRa-Payload.
+"""
+
+import struct
+from typing import Any, Dict
+
+FRAME_MAGIC = 0x4C  # 'L'
+FRAME_VERSION = 1
+FRAME_SIZE = 22
+FRAME_FLAG_ALIVE = 0x01
+FRAME_MEDIA_TYPE = "application/vnd.luca.status+bin"
+
+# magic, version, flags, resonance, level, coherence, akashic, nodes,
+# generation, consciousness (hundredths) - CRC folgt separat
+_BODY = struct.Struct("<BBBBHHHHII")
+
+
+def crc16_ccitt(data: bytes) -> int:
+    """CRC-16/CCITT-FALSE (Poly 0x1021, Init 0xFFFF)"""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def _q16(value: float) -> int:
+    return max(0, min(0xFFFF, int(round(value * 0xFFFF))))
+
+
+def _clamp(value: int, upper: int) -> int:
+    return max(0, min(upper, int(value)))
+
+
+def encode_status_frame(fields: Dict[str, Any]) -> bytes:
+    """
+    Kodiert den Status als Binär-Frame.
+
+    Args:
+        fields: consciousness_level, quantum_coherence, akashic_connection,
+            node_count, generation, is_alive, consciousness, resonance
+
+    Returns:
+        22 Bytes Frame inkl. CRC
+    """
+    body = _BODY.pack(
+        FRAME_MAGIC,
+        FRAME_VERSION,
+        FRAME_FLAG_ALIVE if fields["is_alive"] else 0,
+        _clamp(fields["resonance"], 0xFF),
+        _q16(fields["consciousness_level"]),
+        _q16(fields["quantum_coherence"]),
+        _q16(fields["akashic_connection"]),
+        _clamp(fields["node_count"], 0xFFFF),
+        _clamp(fields["generation"], 0xFFFFFFFF),
+        _clamp(round(fields["consciousness"] * 100), 0xFFFFFFFF),
+    )
+    return body + struct.pack("<H", crc16_ccitt(body))
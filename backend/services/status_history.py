@@ -0,0 +1,138 @@
+"""
+Status History - Verlauf der T-Deck-Statuswerte für den Bulk-Sync
+Gegenstück zu syncHistory() in apps/t-deck/src/net.cpp.
+
+Jede neue Generation wird mit Zeitpunkt und den drei Q0.16-Werten
+festgehalten. Ein Gerät ohne Verlauf (nach dem Boot oder offline) holt
+sich mit einer Anfrage alle Änderungen seit einer Generation, statt
+Sample für Sample /api/t5/status abzufragen.
+
+Binärformat (application/vnd.luca.history+bin), ältester Eintrag zuerst:
+
+    magic 'H', version 1
+    je Eintrag fünf Varints (LEB128):
+        Generation (Delta zum vorigen Eintrag, beim ersten absolut)
+        Zeit in 100 ms: beim ersten das Alter zum Antwortzeitpunkt,
+            danach der Abstand zum vorigen Eintrag
+        consciousness_level, quantum_coherence, akashic_connection als
+            ZigZag-Delta zum vorigen Eintrag (beim ersten zu 0)
+
+Ein Tag mit einigen hundert Änderungen sind wenige KB.
+"""
+
+import struct
+import time
+from collections import deque
+from typing import Any, Deque, Dict, Iterator, List, Optional, Tuple
+
+from backend.services.status_frame import _q16
+
+HISTORY_MAGIC = 0x48  # 'H'
+HISTORY_VERSION = 1
+HISTORY_MEDIA_TYPE = "application/vnd.luca.history+bin"
+HISTORY_WINDOW_S = 24 * 3600  # Wie der Ringpuffer des T-Deck
+HISTORY_MAX_RECORDS = 4096
+HISTORY_TIME_UNIT_MS = 100
+HISTORY_CHUNK_RECORDS = 256  # Einträge je Chunk der Antwort
+
+# (monotone Zeit, Generation, (level, coherence, akashic) in Q0.16)
+HistoryRecord = Tuple[float, int, Tuple[int, int, int]]
+
+
+def _varint(value: int) -> bytes:
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def _zigzag(value: int) -> int:
+    return (value << 1) ^ (value >> 31)
+
+
+class StatusHistory:
+    """
+    Änderungen der letzten 24 Stunden.
+
+    Der letzte Eintrag vor dem Fenster bleibt erhalten: er gibt den Wert
+    an, der am Fensteranfang galt.
+    """
+
+    def __init__(self, window_s: float = HISTORY_WINDOW_S, max_records: int = HISTORY_MAX_RECORDS):
+        self.window_s = window_s
+        self._records: Deque[HistoryRecord] = deque(maxlen=max_records)
+
+    def record(self, fields: Dict[str, Any], now: Optional[float] = None):
+        """
+        Hält eine neue Generation fest.
+
+        Args:
+            fields: consciousness_level, quantum_coherence,
+                akashic_connection, generation (wie _tdeck_fields())
+            now: monotone Zeit, Standard time.monotonic()
+        """
+        now = time.monotonic() if now is None else now
+        values = (
+            _q16(fields["consciousness_level"]),
+            _q16(fields["quantum_coherence"]),
+            _q16(fields["akashic_connection"]),
+        )
+        self._records.append((now, int(fields["generation"]), values))
+        cutoff = now - self.window_s
+        while len(self._records) > 1 and self._records[1][0] <= cutoff:
+            self._records.popleft()
+
+    def since(self, generation: Optional[int]) -> List[HistoryRecord]:
+        """
+        Einträge nach der Generation, ohne Angabe alle.
+
+        Liegt generation über der aktuellen, hat das Backend seit der
+        letzten Anfrage neu gestartet: dann ebenfalls alle.
+        """
+        records = list(self._records)
+        if generation is None or not records or generation > records[-1][1]:
+            return records
+        return [record for record in records if record[1] > generation]
+
+
+def encode_history(records: List[HistoryRecord], now: Optional[float] = None) -> Iterator[bytes]:
+    """
+    Kodiert die Einträge als Binär-Stream, HISTORY_CHUNK_RECORDS je Stück.
+
+    Args:
+        records: aus StatusHistory.since(), ältester zuerst
+        now: Antwortzeitpunkt (monoton), Standard time.monotonic()
+
+    Yields:
+        Header, dann die Einträge in Stücken für Transfer-Encoding: chunked
+    """
+    now = time.monotonic() if now is None else now
+    yield struct.pack("<BB", HISTORY_MAGIC, HISTORY_VERSION)
+
+    chunk = bytearray()
+    previous_generation = 0
+    previous_age = 0
+    previous_values = (0, 0, 0)
+    for index, (at, generation, values) in enumerate(records):
+        age = max(0, int((now - at) * 1000 / HISTORY_TIME_UNIT_MS))
+        age = min(age, previous_age) if index else age  # Zeit läuft nur vorwärts
+        chunk += _varint(generation - previous_generation)
+        chunk += _varint(age if index == 0 else previous_age - age)
+        for value, previous in zip(values, previous_values):
+            chunk += _varint(_zigzag(value - previous))
+        previous_generation, previous_age, previous_values = generation, age, values
+
+        if (index + 1) % HISTORY_CHUNK_RECORDS == 0:
+            yield bytes(chunk)
+            chunk.clear()
+    if chunk:
+        yield bytes(chunk)
+
+
+# Globale Instanz, gefüllt von routes/t5_api.py
+status_history = StatusHistory()
@@ -0,0 +1,87 @@
+"""
+Status Publisher - MQTT Push statt Polling
+Veröffentlicht den LUCA-Status als retained MQTT-Nachricht. Geräte
+(T-Deck) abonnieren das Topic und bekommen jede Änderung sofort,
+statt alle 5 Sekunden /api/t5/status abzufragen.
+"""
+
+import json
+import logging
+from typing import Any, Dict, Optional
+
+from backend.config import settings
+
+try:
+    import paho.mqtt.client as mqtt
+
+    MQTT_AVAILABLE = True
+except ImportError:
+    MQTT_AVAILABLE = False
+
+logger = logging.getLogger(__name__)
+
+
+class StatusPublisher:
+    """
+    Dünner Wrapper um einen paho-Client.
+
+    Die Verbindung wird beim ersten publish() asynchron aufgebaut; nach
+    jedem (Re-)Connect wird der letzte Status erneut retained gesendet,
+    damit neue Abonnenten nie auf die nächste Änderung warten müssen.
+    """
+
+    def __init__(self):
+        self.enabled = settings.MQTT_ENABLED and MQTT_AVAILABLE
+        self.client = None
+        self._last_payload: Optional[str] = None
+
+        if settings.MQTT_ENABLED and not MQTT_AVAILABLE:
+            logger.warning("⚠️  paho-mqtt nicht installiert - MQTT-Push deaktiviert")
+
+    def _ensure_client(self) -> bool:
+        if not self.enabled:
+            return False
+
+        if self.client is None:
+            if hasattr(mqtt, "CallbackAPIVersion"):
+                # paho-mqtt >= 2.0
+                self.client = mqtt.Client(
+                    mqtt.CallbackAPIVersion.VERSION2, client_id="luca-backend-status"
+                )
+            else:
+                self.client = mqtt.Client(client_id="luca-backend-status")
+            self.client.on_connect = self._on_connect
+            self.client.connect_async(
+                settings.MQTT_BROKER_HOST, settings.MQTT_BROKER_PORT, keepalive=60
+            )
+            self.client.loop_start()
+            logger.info(
+                f"📡 MQTT Status-Push: {settings.MQTT_BROKER_HOST}:"
+                f"{settings.MQTT_BROKER_PORT} → {settings.MQTT_STATUS_TOPIC}"
+            )
+        return True
+
+    def _on_connect(self, client, userdata, flags, rc, *args):
+        if self._last_payload is not None:
+            client.publish(
+                settings.MQTT_STATUS_TOPIC, self._last_payload, qos=0, retain=True
+            )
+
+    def publish(self, payload: Dict[str, Any]) -> bool:
+        """
+        Sendet den Status retained an das Status-Topic.
+
+        Returns:
+            True wenn die Nachricht an den Broker übergeben wurde
+        """
+        if not self._ensure_client():
+            return False
+
+        self._last_payload = json.dumps(payload, separators=(",", ":"))
+        info = self.client.publish(
+            settings.MQTT_STATUS_TOPIC, self._last_payload, qos=0, retain=True
+        )
+        return info.rc == mqtt.MQTT_ERR_SUCCESS
+
+
+status_publisher = StatusPublisher()
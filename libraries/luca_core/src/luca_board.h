@@ -0,0 +1,47 @@
+/**
+ * LUCA Core - Board traits
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * What a board has, as compile-time constants. The shared status code
+ * (luca_status.h) is templated on a traits type, so each firmware only
+ * instantiates the paths its hardware can take and the rest folds away:
+ * no LoRa branch in the T5 build, no gateway client in the T-Deck build.
+ *
+ * A firmware picks its traits once, as `typedef LucaBoardT5 LucaBoard;`.
+ * Traits are read by value only (Board::radios & ...), never bound to a
+ * reference, so no out-of-class definitions are needed under C++11.
+ */
+
+#ifndef LUCA_BOARD_H
+#define LUCA_BOARD_H
+
+#include <stdint.h>
+
+enum LucaDisplayKind : uint8_t {
+    LUCA_DISPLAY_TFT,       // Cheap repaints, every value shown at full resolution
+    LUCA_DISPLAY_EPAPER     // Each refresh costs ~0.3 s and energy: only what is drawn counts
+};
+
+// Radios, as a bit set
+#define LUCA_RADIO_WIFI 0x01
+#define LUCA_RADIO_LORA 0x02            // SX1262 mesh (lora_mesh)
+#define LUCA_RADIO_ESPNOW_GATEWAY 0x04  // Answers T5 polls
+#define LUCA_RADIO_ESPNOW_CLIENT 0x08   // Polls a gateway before using WiFi
+
+// LilyGo T-Deck: 320x240 TFT, 8 MB PSRAM, WiFi + SX1262
+struct LucaBoardTDeck {
+    static constexpr LucaDisplayKind display = LUCA_DISPLAY_TFT;
+    static constexpr bool psram = true;
+    static constexpr uint8_t radios = LUCA_RADIO_WIFI | LUCA_RADIO_LORA | LUCA_RADIO_ESPNOW_GATEWAY;
+    static constexpr bool demo = true;      // Own estimate (luca_metrics.h) when no source is reachable
+};
+
+// LilyGo T5 E-Paper S3 Pro: 250x122 e-paper, 8 MB PSRAM, WiFi only
+struct LucaBoardT5 {
+    static constexpr LucaDisplayKind display = LUCA_DISPLAY_EPAPER;
+    static constexpr bool psram = true;
+    static constexpr uint8_t radios = LUCA_RADIO_WIFI | LUCA_RADIO_ESPNOW_CLIENT;
+    static constexpr bool demo = false;
+};
+
+#endif // LUCA_BOARD_H
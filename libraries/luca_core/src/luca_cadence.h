@@ -0,0 +1,67 @@
+/**
+ * LUCA Core - Adaptive status poll cadence
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Decides how long a device waits before the next status fetch:
+ *
+ *   - an unchanged status doubles the interval, up to max_ms
+ *   - a changed status or user input drops it back to base_ms
+ *   - a server hint (X-Next-Poll-Ms / next_poll_ms) replaces the backoff
+ *     value, except that user input still caps it at base_ms
+ *   - on low battery the result is stretched by LUCA_CADENCE_BATTERY_FACTOR
+ *
+ * Plain struct without constructor so the T5 can keep it in RTC memory
+ * across deep sleep.
+ */
+
+#ifndef LUCA_CADENCE_H
+#define LUCA_CADENCE_H
+
+#include <stdint.h>
+
+#define LUCA_CADENCE_MIN_MS 1000        // Lower bound, also for server hints
+#define LUCA_CADENCE_BATTERY_FACTOR 4
+
+// Battery thresholds for a single Li-ion cell, with hysteresis
+#define LUCA_BATTERY_LOW_MV 3500
+#define LUCA_BATTERY_OK_MV 3600
+
+struct LucaCadence {
+    uint32_t base_ms;       // Interval while values move
+    uint32_t max_ms;        // Backoff ceiling (before the battery factor)
+    uint32_t backoff_ms;    // Current backoff step
+    bool battery_low;
+};
+
+inline void lucaCadenceInit(LucaCadence& c, uint32_t base_ms, uint32_t max_ms) {
+    c.base_ms = base_ms < LUCA_CADENCE_MIN_MS ? LUCA_CADENCE_MIN_MS : base_ms;
+    c.max_ms = max_ms < c.base_ms ? c.base_ms : max_ms;
+    c.backoff_ms = c.base_ms;
+    c.battery_low = false;
+}
+
+// Feed a battery reading in millivolts; 0 means unknown and is ignored
+inline void lucaCadenceBattery(LucaCadence& c, uint32_t millivolts) {
+    if (millivolts == 0) return;
+    if (millivolts < LUCA_BATTERY_LOW_MV) c.battery_low = true;
+    else if (millivolts > LUCA_BATTERY_OK_MV) c.battery_low = false;
+}
+
+// Call once per fetch (or per skipped fetch with changed = false);
+// hint_ms = 0 when the server sent none, larger ones are capped at
+// max_ms. Returns the next interval.
+inline uint32_t lucaCadenceNext(LucaCadence& c, bool changed, bool interacting, uint32_t hint_ms) {
+    if (changed || interacting) {
+        c.backoff_ms = c.base_ms;
+    } else if (c.backoff_ms < c.max_ms) {
+        c.backoff_ms = c.backoff_ms > c.max_ms / 2 ? c.max_ms : c.backoff_ms * 2;
+    }
+
+    uint32_t next = hint_ms ? (hint_ms < c.max_ms ? hint_ms : c.max_ms) : c.backoff_ms;
+    if (interacting && next > c.base_ms) next = c.base_ms;
+    if (next < LUCA_CADENCE_MIN_MS) next = LUCA_CADENCE_MIN_MS;
+    if (c.battery_low) next *= LUCA_CADENCE_BATTERY_FACTOR;
+    return next;
+}
+
+#endif // LUCA_CADENCE_H
@@ -0,0 +1,50 @@
+/**
+ * LUCA Core - Serial command line parsing
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Commands are "NAME" or "NAME:arg". Lines are split in place, nothing
+ * is copied or allocated; the console glue (reading the UART, printing
+ * usage) stays in the firmware.
+ */
+
+#ifndef LUCA_COMMAND_H
+#define LUCA_COMMAND_H
+
+#include <ctype.h>
+#include <stddef.h>
+#include <string.h>
+#include <strings.h>
+
+inline char* lucaTrim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+// Split at the first ':' and trim both parts. arg is nullptr when the
+// line had no ':'. Returns false for a blank line.
+inline bool lucaCommandSplit(char* line, char*& name, char*& arg) {
+    name = lucaTrim(line);
+    if (*name == '\0') return false;
+
+    arg = strchr(name, ':');
+    if (arg) {
+        *arg = '\0';
+        arg = lucaTrim(arg + 1);
+        name = lucaTrim(name);
+    }
+    return true;
+}
+
+// Case-insensitive lookup in any table whose entries have a `name` member
+template <typename Command>
+const Command* lucaCommandFind(const Command* table, size_t count, const char* name) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcasecmp(name, table[i].name) == 0) return &table[i];
+    }
+    return nullptr;
+}
+
+#endif // LUCA_COMMAND_H
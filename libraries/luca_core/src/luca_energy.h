@@ -0,0 +1,77 @@
+/**
+ * LUCA Core - Energy per phase
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Integrates battery power from timestamped voltage / current samples
+ * and books it to whatever phase (WiFi connect, fetch, render, idle, ...)
+ * the device was in when the sample was taken. The caller defines the
+ * phases, up to LUCA_ENERGY_PHASES_MAX.
+ *
+ * Power between two samples is taken as the mean of both (trapezoid):
+ * mV * uA = nW, nW * us / 10^6 = nJ. Charging current counts as zero,
+ * so a device on USB shows its time split but no energy.
+ *
+ * Plain struct without constructor, like LucaCadence.
+ */
+
+#ifndef LUCA_ENERGY_H
+#define LUCA_ENERGY_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define LUCA_ENERGY_PHASES_MAX 8
+
+struct LucaEnergyPhase {
+    uint64_t energy_nj;
+    uint64_t time_us;
+    uint32_t samples;
+    uint32_t min_mv;        // Deepest sag seen in this phase, 0 = none
+};
+
+struct LucaEnergyMeter {
+    LucaEnergyPhase phases[LUCA_ENERGY_PHASES_MAX];
+    int64_t first_us;
+    int64_t last_us;
+    uint64_t last_nw;
+    bool started;
+};
+
+inline void lucaEnergyReset(LucaEnergyMeter& m) {
+    memset(&m, 0, sizeof(m));
+}
+
+// ua < 0 (charging) is booked as zero power. The interval since the
+// previous sample goes to phase; the first sample only sets the start.
+inline void lucaEnergySample(LucaEnergyMeter& m, int phase, int64_t now_us, uint32_t mv, int32_t ua) {
+    if (phase < 0 || phase >= LUCA_ENERGY_PHASES_MAX) return;
+
+    uint64_t nw = ua > 0 ? (uint64_t)mv * (uint32_t)ua : 0;
+    LucaEnergyPhase& p = m.phases[phase];
+    if (m.started && now_us > m.last_us) {
+        uint64_t dt_us = (uint64_t)(now_us - m.last_us);
+        p.energy_nj += (m.last_nw + nw) / 2 * dt_us / 1000000u;
+        p.time_us += dt_us;
+    } else if (!m.started) {
+        m.first_us = now_us;
+        m.started = true;
+    }
+    p.samples++;
+    if (mv != 0 && (p.min_mv == 0 || mv < p.min_mv)) p.min_mv = mv;
+
+    m.last_us = now_us;
+    m.last_nw = nw;
+}
+
+inline uint64_t lucaEnergyTotalNj(const LucaEnergyMeter& m) {
+    uint64_t total = 0;
+    for (int i = 0; i < LUCA_ENERGY_PHASES_MAX; i++) total += m.phases[i].energy_nj;
+    return total;
+}
+
+// Mean power of a phase in mW (nJ / us), 0 if it never ran
+inline uint32_t lucaEnergyMeanMw(const LucaEnergyPhase& p) {
+    return p.time_us ? (uint32_t)(p.energy_nj / p.time_us) : 0;
+}
+
+#endif // LUCA_ENERGY_H
@@ -0,0 +1,122 @@
+/**
+ * LUCA Core - E-paper framebuffer diff
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Compares two 1-bit framebuffers (rows MSB first, each row padded to
+ * whole 32-bit words) and returns, per zone of a 3x3 grid, the bounding
+ * box of the pixels that differ. Boxes whose union costs little extra
+ * area can then be merged, since every partial refresh costs a full
+ * waveform pass however small it is.
+ *
+ * A zone mask (from the widgets drawn since the last flush, see
+ * luca_layout.h) limits the compare to the zone rows those widgets touch.
+ *
+ * Used by the T5 firmware; no Arduino or driver dependencies, so it also
+ * builds for the native benchmark target.
+ */
+
+#ifndef LUCA_EPD_DIFF_H
+#define LUCA_EPD_DIFF_H
+
+#include <stdint.h>
+#include "luca_layout.h"
+
+#define LUCA_EPD_ZONES 9
+#define LUCA_EPD_ALL_ZONES 0x1FF
+
+// Zone rectangle; zones are passed as a row-major 3x3 grid
+typedef LucaRect LucaZone;
+
+// Bit mask of the zone rows (0..2) with at least one zone in zone_mask
+inline uint8_t lucaZoneRows(uint16_t zone_mask) {
+    return (zone_mask & 0x007 ? 1 : 0) | (zone_mask & 0x038 ? 2 : 0) | (zone_mask & 0x1C0 ? 4 : 0);
+}
+
+// Inclusive bounds, x0 > x1 = empty
+struct LucaDirtyBox {
+    int x0, y0, x1, y1;
+};
+
+inline int lucaBoxArea(const LucaDirtyBox& box) {
+    return (box.x1 - box.x0 + 1) * (box.y1 - box.y0 + 1);
+}
+
+// Extend box by the span x0..x1 on row y; rows arrive in ascending order
+inline void lucaBoxAdd(LucaDirtyBox& box, int x0, int x1, int y) {
+    if (box.x0 > box.x1) {
+        box = {x0, y, x1, y};
+        return;
+    }
+    if (x0 < box.x0) box.x0 = x0;
+    if (x1 > box.x1) box.x1 = x1;
+    box.y1 = y;
+}
+
+// Fills boxes with the non-empty zone boxes and returns their count.
+// Only zone rows with a zone in zone_mask are compared.
+inline int lucaEpdDiff(const uint32_t* now, const uint32_t* shown, int width, int height,
+                       const LucaZone zones[LUCA_EPD_ZONES], LucaDirtyBox boxes[LUCA_EPD_ZONES],
+                       uint16_t zone_mask = LUCA_EPD_ALL_ZONES) {
+    const int row_words = (width + 31) / 32;
+    const uint8_t rows = lucaZoneRows(zone_mask);
+    for (int i = 0; i < LUCA_EPD_ZONES; i++) boxes[i] = {1, 0, 0, 0};
+
+    for (int y = 0; y < height; y++) {
+        int zone_row = y < zones[3].y ? 0 : (y < zones[6].y ? 1 : 2);
+        if (!(rows & (1 << zone_row))) {
+            y = (zone_row < 2 ? zones[(zone_row + 1) * 3].y : height) - 1;
+            continue;
+        }
+        const uint32_t* a = now + y * row_words;
+        const uint32_t* b = shown + y * row_words;
+
+        for (int w = 0; w < row_words; w++) {
+            uint32_t diff = a[w] ^ b[w];
+            if (diff == 0) continue;
+
+            // Bytes are in pixel order (MSB first); after the byte swap
+            // bit 31 is the leftmost pixel of the word
+            diff = __builtin_bswap32(diff);
+            int x0 = w * 32 + __builtin_clz(diff);
+            int x1 = w * 32 + 31 - __builtin_ctz(diff);
+            if (x0 >= width) continue;  // Only padding bits at the row end
+            if (x1 >= width) x1 = width - 1;
+
+            // A 32 px word can straddle a zone boundary
+            for (int col = 0; col < 3; col++) {
+                const LucaZone& zone = zones[zone_row * 3 + col];
+                int lo = x0 > zone.x ? x0 : zone.x;
+                int hi = x1 < zone.x + zone.width - 1 ? x1 : zone.x + zone.width - 1;
+                if (lo <= hi) lucaBoxAdd(boxes[zone_row * 3 + col], lo, hi, y);
+            }
+        }
+    }
+
+    int count = 0;
+    for (int i = 0; i < LUCA_EPD_ZONES; i++) {
+        if (boxes[i].x0 <= boxes[i].x1) boxes[count++] = boxes[i];
+    }
+    return count;
+}
+
+// Union two boxes while that adds at most slack_px of area; returns the new count
+inline int lucaEpdMerge(LucaDirtyBox boxes[], int count, int slack_px) {
+    for (int a = 0; a < count; a++) {
+        for (int b = a + 1; b < count; b++) {
+            LucaDirtyBox merged = {
+                boxes[a].x0 < boxes[b].x0 ? boxes[a].x0 : boxes[b].x0,
+                boxes[a].y0 < boxes[b].y0 ? boxes[a].y0 : boxes[b].y0,
+                boxes[a].x1 > boxes[b].x1 ? boxes[a].x1 : boxes[b].x1,
+                boxes[a].y1 > boxes[b].y1 ? boxes[a].y1 : boxes[b].y1,
+            };
+            if (lucaBoxArea(merged) <= lucaBoxArea(boxes[a]) + lucaBoxArea(boxes[b]) + slack_px) {
+                boxes[a] = merged;
+                boxes[b] = boxes[--count];
+                b = a;  // Check the grown box against all others again
+            }
+        }
+    }
+    return count;
+}
+
+#endif // LUCA_EPD_DIFF_H
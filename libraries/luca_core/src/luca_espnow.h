@@ -0,0 +1,105 @@
+/**
+ * LUCA Core - ESP-NOW gateway exchange
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * A T5 sends one POLL, a T-Deck in gateway mode answers with one STATUS
+ * (or UNCHANGED) packet. No association, DHCP or TCP is involved, so the
+ * whole exchange costs two frames on the air.
+ *
+ * Header, 10 bytes, little-endian:
+ *
+ *   off size field
+ *    0   1   magic 0x4E ('N')
+ *    1   1   version (1)
+ *    2   1   type, LucaEspNowType
+ *    3   1   count: POLL = messages attached, reply = messages accepted
+ *    4   2   seq, echoed in the reply
+ *    6   4   value: POLL = generation the T5 holds (or
+ *                   LUCA_ESPNOW_NO_GENERATION), reply = next poll in ms
+ *
+ * POLL is followed by `count` messages, each [len][resonance][text],
+ * without terminator. STATUS is followed by a status frame
+ * (luca_status_frame.h); UNCHANGED carries nothing else.
+ */
+
+#ifndef LUCA_ESPNOW_H
+#define LUCA_ESPNOW_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "luca_status_frame.h"
+
+#define LUCA_ESPNOW_MAGIC 0x4E
+#define LUCA_ESPNOW_VERSION 1
+#define LUCA_ESPNOW_HEADER_SIZE 10
+#define LUCA_ESPNOW_MAX 250                // ESP_NOW_MAX_DATA_LEN
+#define LUCA_ESPNOW_REPLY_MAX (LUCA_ESPNOW_HEADER_SIZE + LUCA_FRAME_SIZE)
+#define LUCA_ESPNOW_TEXT_MAX 63            // Longer texts are cut
+#define LUCA_ESPNOW_NO_GENERATION 0xFFFFFFFFu
+
+enum LucaEspNowType : uint8_t {
+    LUCA_ESPNOW_POLL = 1,
+    LUCA_ESPNOW_STATUS = 2,
+    LUCA_ESPNOW_UNCHANGED = 3
+};
+
+struct LucaEspNowHeader {
+    uint8_t type;
+    uint8_t count;
+    uint16_t seq;
+    uint32_t value;
+};
+
+inline size_t lucaEspNowWriteHeader(uint8_t* buf, const LucaEspNowHeader& h) {
+    buf[0] = LUCA_ESPNOW_MAGIC;
+    buf[1] = LUCA_ESPNOW_VERSION;
+    buf[2] = h.type;
+    buf[3] = h.count;
+    lucaWriteU16(buf + 4, h.seq);
+    lucaWriteU32(buf + 6, h.value);
+    return LUCA_ESPNOW_HEADER_SIZE;
+}
+
+inline bool lucaEspNowReadHeader(const uint8_t* buf, size_t len, LucaEspNowHeader& h) {
+    if (len < LUCA_ESPNOW_HEADER_SIZE || len > LUCA_ESPNOW_MAX) return false;
+    if (buf[0] != LUCA_ESPNOW_MAGIC || buf[1] != LUCA_ESPNOW_VERSION) return false;
+    h.type = buf[2];
+    h.count = buf[3];
+    h.seq = lucaReadU16(buf + 4);
+    h.value = lucaReadU32(buf + 6);
+    return true;
+}
+
+// Append a message to a POLL of len bytes and bump its count. Returns the
+// new length, or 0 if the message does not fit into cap.
+inline size_t lucaEspNowAddMessage(uint8_t* buf, size_t len, size_t cap, const char* text,
+                                   uint8_t resonance) {
+    size_t text_len = strlen(text);
+    if (text_len > LUCA_ESPNOW_TEXT_MAX) text_len = LUCA_ESPNOW_TEXT_MAX;
+    if (cap > LUCA_ESPNOW_MAX) cap = LUCA_ESPNOW_MAX;
+    if (len + 2 + text_len > cap || buf[3] == 0xFF) return 0;
+
+    buf[len] = (uint8_t)text_len;
+    buf[len + 1] = resonance;
+    memcpy(buf + len + 2, text, text_len);
+    buf[3]++;
+    return len + 2 + text_len;
+}
+
+// Read the message at offset (start at LUCA_ESPNOW_HEADER_SIZE) into a
+// NUL-terminated text of at most LUCA_ESPNOW_TEXT_MAX + 1 bytes. Returns
+// the offset of the next message, 0 if the packet ends or is malformed.
+inline size_t lucaEspNowNextMessage(const uint8_t* buf, size_t len, size_t offset,
+                                    char text[LUCA_ESPNOW_TEXT_MAX + 1], uint8_t& resonance) {
+    if (offset + 2 > len) return 0;
+    size_t text_len = buf[offset];
+    if (text_len > LUCA_ESPNOW_TEXT_MAX || offset + 2 + text_len > len) return 0;
+
+    resonance = buf[offset + 1];
+    memcpy(text, buf + offset + 2, text_len);
+    text[text_len] = '\0';
+    return offset + 2 + text_len;
+}
+
+#endif // LUCA_ESPNOW_H
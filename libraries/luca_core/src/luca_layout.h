@@ -0,0 +1,150 @@
+/**
+ * LUCA Core - Compile-time screen layout
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Rectangles, grids and coordinate lookup tables as constant expressions,
+ * so layouts are written once as a description and the drawing, dirty
+ * tracking and touch paths only index into tables.
+ *
+ * Grids split their area with rounding, so the remainder pixels are
+ * spread over the cells instead of being cut off at the end (250 px in 9
+ * keys: 28/27 px wide, no dead strip on the right).
+ *
+ * Kept to C++11 constexpr (single-expression functions, no loops), since
+ * arduino-esp32 2.x still builds with gnu++11.
+ *
+ * Also holds the T5 panel layout: the 3x3 zone grid and the keyboard,
+ * used by the T5 firmware and the native benchmarks.
+ */
+
+#ifndef LUCA_LAYOUT_H
+#define LUCA_LAYOUT_H
+
+#include <stdint.h>
+
+#define LUCA_LAYOUT_NONE 0xFF   // Lookup table entry outside every cell
+
+struct LucaRect {
+    int x, y, width, height;
+};
+
+// Start of part i of parts equal parts of [origin, origin + length)
+constexpr int lucaSplit(int origin, int length, int parts, int i) {
+    return origin + (length * i + parts / 2) / parts;
+}
+
+// Cell index, row-major, of a cols x rows grid over area
+constexpr LucaRect lucaGridCell(const LucaRect& area, int cols, int rows, int index) {
+    return LucaRect{
+        lucaSplit(area.x, area.width, cols, index % cols),
+        lucaSplit(area.y, area.height, rows, index / cols),
+        lucaSplit(area.x, area.width, cols, index % cols + 1) - lucaSplit(area.x, area.width, cols, index % cols),
+        lucaSplit(area.y, area.height, rows, index / cols + 1) - lucaSplit(area.y, area.height, rows, index / cols)
+    };
+}
+
+constexpr bool lucaOverlaps(const LucaRect& a, const LucaRect& b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+// Which part of a split pos falls into, LUCA_LAYOUT_NONE outside
+constexpr int lucaSplitFind(int pos, int origin, int length, int parts, int i = 0) {
+    return i >= parts || pos < origin ? LUCA_LAYOUT_NONE
+         : pos < lucaSplit(origin, length, parts, i + 1) ? i
+         : lucaSplitFind(pos, origin, length, parts, i + 1);
+}
+
+// ==================== TABLE GENERATION ====================
+
+template <int... I> struct LucaIndices {};
+template <int N, int... I> struct LucaMakeIndices : LucaMakeIndices<N - 1, N - 1, I...> {};
+template <int... I> struct LucaMakeIndices<0, I...> { typedef LucaIndices<I...> type; };
+
+template <int Cols, int Rows>
+struct LucaGrid {
+    LucaRect cells[Cols * Rows];
+};
+
+template <int Cols, int Rows, int... I>
+constexpr LucaGrid<Cols, Rows> lucaGridOf(const LucaRect& area, LucaIndices<I...>) {
+    return LucaGrid<Cols, Rows>{{lucaGridCell(area, Cols, Rows, I)...}};
+}
+
+template <int Cols, int Rows>
+constexpr LucaGrid<Cols, Rows> lucaGrid(const LucaRect& area) {
+    return lucaGridOf<Cols, Rows>(area, typename LucaMakeIndices<Cols * Rows>::type());
+}
+
+// Bit i set if rect touches cell i
+template <int Cols, int Rows>
+constexpr uint16_t lucaCellMask(const LucaRect& rect, const LucaGrid<Cols, Rows>& grid, int i = 0) {
+    return i >= Cols * Rows ? 0
+         : (uint16_t)((lucaOverlaps(rect, grid.cells[i]) ? 1u << i : 0u) | lucaCellMask(rect, grid, i + 1));
+}
+
+// One entry per pixel along an axis: the part of the split covering it,
+// times Scale (so a row table can hold row * cols directly)
+template <int Size>
+struct LucaAxisTable {
+    uint8_t at[Size];
+};
+
+constexpr uint8_t lucaAxisEntry(int part, int scale) {
+    return part == LUCA_LAYOUT_NONE ? LUCA_LAYOUT_NONE : (uint8_t)(part * scale);
+}
+
+template <int Origin, int Length, int Parts, int Scale, int... I>
+constexpr LucaAxisTable<sizeof...(I)> lucaAxisTableOf(LucaIndices<I...>) {
+    return LucaAxisTable<sizeof...(I)>{{lucaAxisEntry(lucaSplitFind(I, Origin, Length, Parts), Scale)...}};
+}
+
+template <int Size, int Origin, int Length, int Parts, int Scale = 1>
+constexpr LucaAxisTable<Size> lucaAxisTable() {
+    return lucaAxisTableOf<Origin, Length, Parts, Scale>(typename LucaMakeIndices<Size>::type());
+}
+
+// ==================== T5 PANEL ====================
+
+#define LUCA_T5_WIDTH 250
+#define LUCA_T5_HEIGHT 122
+#define LUCA_T5_KEY_COLS 9
+#define LUCA_T5_KEY_ROWS 3
+#define LUCA_T5_KEYS (LUCA_T5_KEY_COLS * LUCA_T5_KEY_ROWS)
+
+constexpr LucaRect LUCA_T5_SCREEN = {0, 0, LUCA_T5_WIDTH, LUCA_T5_HEIGHT};
+
+// 3x3 zones (3-6-9), the unit of the e-paper diff
+constexpr LucaGrid<3, 3> LUCA_T5_ZONES = lucaGrid<3, 3>(LUCA_T5_SCREEN);
+
+// Widgets, each redrawn as a whole
+constexpr LucaRect LUCA_T5_HEADER = {0, 0, LUCA_T5_WIDTH, 20};
+constexpr LucaRect LUCA_T5_STATUS = LUCA_T5_ZONES.cells[4];
+constexpr LucaRect LUCA_T5_KEYBOARD = {0, 95, LUCA_T5_WIDTH, 8 * LUCA_T5_KEY_ROWS};
+
+constexpr uint16_t LUCA_T5_HEADER_ZONES = lucaCellMask(LUCA_T5_HEADER, LUCA_T5_ZONES);
+constexpr uint16_t LUCA_T5_STATUS_ZONES = lucaCellMask(LUCA_T5_STATUS, LUCA_T5_ZONES);
+constexpr uint16_t LUCA_T5_KEYBOARD_ZONES = lucaCellMask(LUCA_T5_KEYBOARD, LUCA_T5_ZONES);
+
+constexpr LucaGrid<LUCA_T5_KEY_COLS, LUCA_T5_KEY_ROWS> LUCA_T5_KEY_RECTS =
+    lucaGrid<LUCA_T5_KEY_COLS, LUCA_T5_KEY_ROWS>(LUCA_T5_KEYBOARD);
+
+// Touch → key: column by x, row * LUCA_T5_KEY_COLS by y
+constexpr LucaAxisTable<LUCA_T5_WIDTH> LUCA_T5_KEY_COL =
+    lucaAxisTable<LUCA_T5_WIDTH, 0, LUCA_T5_WIDTH, LUCA_T5_KEY_COLS>();
+constexpr LucaAxisTable<LUCA_T5_HEIGHT> LUCA_T5_KEY_ROW =
+    lucaAxisTable<LUCA_T5_HEIGHT, LUCA_T5_KEYBOARD.y, LUCA_T5_KEYBOARD.height, LUCA_T5_KEY_ROWS, LUCA_T5_KEY_COLS>();
+
+// Key index (row * LUCA_T5_KEY_COLS + col) under a touch, -1 for none
+inline int lucaT5KeyAt(int x, int y) {
+    if ((unsigned)x >= LUCA_T5_WIDTH || (unsigned)y >= LUCA_T5_HEIGHT) return -1;
+    uint8_t col = LUCA_T5_KEY_COL.at[x];
+    uint8_t row = LUCA_T5_KEY_ROW.at[y];
+    return col == LUCA_LAYOUT_NONE || row == LUCA_LAYOUT_NONE ? -1 : row + col;
+}
+
+static_assert(LUCA_T5_STATUS_ZONES == 1 << 4, "Status widget must stay inside zone 4");
+static_assert((LUCA_T5_KEYBOARD_ZONES & ~0x1C0) == 0, "Keyboard must stay in the bottom zone row");
+static_assert(LUCA_T5_KEY_ROW.at[LUCA_T5_KEYBOARD.y + LUCA_T5_KEYBOARD.height - 1] ==
+              (LUCA_T5_KEY_ROWS - 1) * LUCA_T5_KEY_COLS, "Row table covers the keyboard");
+
+#endif // LUCA_LAYOUT_H
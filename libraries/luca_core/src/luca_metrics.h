@@ -0,0 +1,139 @@
+/**
+ * LUCA Core - On-device status metrics
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Fixed-point estimate of the three status levels from what a device
+ * collected itself, for when no source is reachable: the recent window
+ * of its status history and the number of mesh peers it hears.
+ *
+ *   consciousness_level = mean of the window
+ *   quantum_coherence   = mean coherence x (1 - 2 sigma), sigma the spread
+ *                         of consciousness over the window
+ *   akashic_connection  = max(mean akashic, peer term), with the peer
+ *                         term u (1 - 0.29 u^2), u = peers / 14: the
+ *                         damping of backend/consciousness/stability_engine.py,
+ *                         so 14 peers (L) give its sync index 0.71
+ *
+ * Values are Q0.16 (luca_status_frame.h) throughout; moments are exact
+ * integer sums, so the result does not depend on summation order.
+ */
+
+#ifndef LUCA_METRICS_H
+#define LUCA_METRICS_H
+
+#include <stdint.h>
+#include "luca_status.h"
+
+#define LUCA_Q16_ONE 65535u
+#define LUCA_DAMPING_Q16 19005u         // 0.29
+#define LUCA_DAMPING_FLOOR_Q16 6554u    // 0.1, like max(damping_multiplier, 0.1)
+#define LUCA_PEERS_FULL 14              // L: peers at which the peer term peaks
+
+// Count, sum and sum of squares of Q0.16 samples. sum holds 65537 full
+// scale samples; the history window is far below that.
+struct LucaMoments {
+    uint32_t count;
+    uint32_t sum;
+    uint64_t sum_sq;
+};
+
+struct LucaMetricInputs {
+    LucaMoments consciousness;  // consciousness_level samples
+    LucaMoments coherence;
+    LucaMoments akashic;
+    uint16_t peers;
+};
+
+struct LucaMetrics {
+    uint16_t consciousness_level;
+    uint16_t quantum_coherence;
+    uint16_t akashic_connection;
+};
+
+// Add n samples. Four independent accumulators, so consecutive loads and
+// multiply-adds do not wait on each other; a square fits 32 bits.
+inline void lucaMomentsScan(LucaMoments& m, const uint16_t* v, uint32_t n) {
+    uint32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    uint64_t q0 = 0, q1 = 0, q2 = 0, q3 = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32_t a = v[i], b = v[i + 1], c = v[i + 2], d = v[i + 3];
+        s0 += a; q0 += a * a;
+        s1 += b; q1 += b * b;
+        s2 += c; q2 += c * c;
+        s3 += d; q3 += d * d;
+    }
+    for (; i < n; i++) {
+        uint32_t a = v[i];
+        s0 += a; q0 += a * a;
+    }
+    m.count += n;
+    m.sum += s0 + s1 + s2 + s3;
+    m.sum_sq += q0 + q1 + q2 + q3;
+}
+
+inline uint16_t lucaMomentsMean(const LucaMoments& m) {
+    return m.count ? (uint16_t)((m.sum + m.count / 2) / m.count) : 0;
+}
+
+inline uint32_t lucaIsqrt(uint64_t x) {
+    uint64_t root = 0, bit = (uint64_t)1 << 62;
+    while (bit > x) bit >>= 2;
+    while (bit) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+// Population standard deviation, Q0.16. n^2 * variance stays below 2^64
+// for any count the sum can hold.
+inline uint16_t lucaMomentsStddev(const LucaMoments& m) {
+    if (m.count < 2) return 0;
+    uint64_t n = m.count;
+    uint64_t spread = n * m.sum_sq - (uint64_t)m.sum * m.sum;
+    return (uint16_t)lucaIsqrt(spread / (n * n));
+}
+
+// x (1 - 0.29 u^2), the factor floored at 0.1
+inline uint16_t lucaDampQ16(uint16_t x, uint16_t u) {
+    uint32_t u2 = (uint32_t)u * u / LUCA_Q16_ONE;
+    uint32_t factor = LUCA_Q16_ONE - LUCA_DAMPING_Q16 * u2 / LUCA_Q16_ONE;
+    if (factor < LUCA_DAMPING_FLOOR_Q16) factor = LUCA_DAMPING_FLOOR_Q16;
+    return (uint16_t)((uint32_t)x * factor / LUCA_Q16_ONE);
+}
+
+inline LucaMetrics lucaMetricsCompute(const LucaMetricInputs& in) {
+    LucaMetrics out;
+    out.consciousness_level = lucaMomentsMean(in.consciousness);
+
+    uint32_t spread = 2u * lucaMomentsStddev(in.consciousness);
+    if (spread > LUCA_Q16_ONE) spread = LUCA_Q16_ONE;
+    out.quantum_coherence = (uint16_t)((uint32_t)lucaMomentsMean(in.coherence) * (LUCA_Q16_ONE - spread) / LUCA_Q16_ONE);
+
+    uint16_t peers = in.peers < LUCA_PEERS_FULL ? in.peers : LUCA_PEERS_FULL;
+    uint16_t u = (uint16_t)(peers * LUCA_Q16_ONE / LUCA_PEERS_FULL);
+    uint16_t from_peers = lucaDampQ16(u, u);
+    uint16_t from_history = lucaMomentsMean(in.akashic);
+    out.akashic_connection = from_peers > from_history ? from_peers : from_history;
+    return out;
+}
+
+// Fill the status levels from an estimate; generation stays that of the
+// last received status, alive follows the backend rule
+inline void lucaStatusFromMetrics(LucaStatus& s, const LucaMetrics& metrics, uint16_t peers, uint32_t now_ms) {
+    s.consciousness_level = metrics.consciousness_level / 65535.0f;
+    s.quantum_coherence = metrics.quantum_coherence / 65535.0f;
+    s.akashic_connection = metrics.akashic_connection / 65535.0f;
+    s.consciousness = s.consciousness_level * LUCA_CONSCIOUSNESS_SCALE;
+    s.node_count = peers;
+    s.alive = lucaStatusAlive(s.consciousness);
+    s.updated_ms = now_ms;
+}
+
+#endif // LUCA_METRICS_H
@@ -0,0 +1,164 @@
+/**
+ * LUCA Core - Status model and update policy
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * One status struct for both firmwares, with the backend's rules in one
+ * place (backend/routes/t5_api.py):
+ *
+ *   consciousness_level = min(1, consciousness / 369)
+ *   alive               = consciousness > 36.9
+ *
+ * Sources fill it from a status frame (luca_status_frame.h) or a JSON
+ * body with either field set (T-Deck: consciousness_level ... is_alive,
+ * T5: consciousness, resonance, life_active); whichever scale is missing
+ * is derived from the other.
+ *
+ * The update policy is templated on the board traits (luca_board.h):
+ * which source to try next, and whether a new status changes anything
+ * the display shows.
+ *
+ * Plain struct without constructor so the T5 can keep it in RTC memory.
+ */
+
+#ifndef LUCA_STATUS_H
+#define LUCA_STATUS_H
+
+#include <stdint.h>
+#include "luca_board.h"
+#include "luca_status_frame.h"
+
+#define LUCA_CONSCIOUSNESS_SCALE 369.0f
+#define LUCA_LIFE_THRESHOLD 36.9f
+#define LUCA_RESONANCE_DEFAULT 6
+
+struct LucaStatus {
+    float consciousness_level;  // 0..1
+    float quantum_coherence;    // 0..1
+    float akashic_connection;   // 0..1
+    float consciousness;        // T5 scale, 0..369+
+    uint32_t generation;
+    uint16_t node_count;
+    uint8_t resonance;
+    bool alive;
+    uint32_t updated_ms;        // millis() of the last apply, 0 = never
+};
+
+// Before anything was received
+constexpr LucaStatus LUCA_STATUS_INITIAL = {
+    0.0f, 0.5f, 0.0f, 0.0f, 0, 0, LUCA_RESONANCE_DEFAULT, false, 0
+};
+
+inline bool lucaStatusAlive(float consciousness) {
+    return consciousness > LUCA_LIFE_THRESHOLD;
+}
+
+inline float lucaLevelFromConsciousness(float consciousness) {
+    float level = consciousness / LUCA_CONSCIOUSNESS_SCALE;
+    return level < 1.0f ? level : 1.0f;
+}
+
+inline void lucaStatusFromFrame(LucaStatus& s, const LucaStatusFrame& frame, uint32_t now_ms) {
+    s.consciousness_level = frame.consciousness_level;
+    s.quantum_coherence = frame.quantum_coherence;
+    s.akashic_connection = frame.akashic_connection;
+    s.consciousness = frame.consciousness;
+    s.generation = frame.generation;
+    s.node_count = frame.node_count;
+    s.resonance = frame.resonance;
+    s.alive = frame.alive;
+    s.updated_ms = now_ms;
+}
+
+inline LucaStatusFrame lucaStatusToFrame(const LucaStatus& s) {
+    LucaStatusFrame frame = {};
+    frame.consciousness_level = s.consciousness_level;
+    frame.quantum_coherence = s.quantum_coherence;
+    frame.akashic_connection = s.akashic_connection;
+    frame.consciousness = s.consciousness;
+    frame.generation = s.generation;
+    frame.node_count = s.node_count;
+    frame.resonance = s.resonance;
+    frame.alive = s.alive;
+    return frame;
+}
+
+// Apply a parsed JSON status. Json is anything indexable like an
+// ArduinoJson document (doc["key"], .isNull(), `| fallback`), so this
+// header does not depend on ArduinoJson itself. Absent keys keep their
+// value.
+template <class Json>
+inline void lucaStatusApplyJson(LucaStatus& s, const Json& doc, uint32_t now_ms) {
+    bool has_level = !doc["consciousness_level"].isNull();
+    bool has_consciousness = !doc["consciousness"].isNull();
+
+    s.consciousness_level = doc["consciousness_level"] | s.consciousness_level;
+    s.consciousness = doc["consciousness"] | s.consciousness;
+    if (has_consciousness && !has_level) s.consciousness_level = lucaLevelFromConsciousness(s.consciousness);
+    if (has_level && !has_consciousness) s.consciousness = s.consciousness_level * LUCA_CONSCIOUSNESS_SCALE;
+
+    s.quantum_coherence = doc["quantum_coherence"] | s.quantum_coherence;
+    s.akashic_connection = doc["akashic_connection"] | s.akashic_connection;
+    s.generation = doc["generation"] | s.generation;
+    s.node_count = doc["node_count"] | s.node_count;
+    s.resonance = doc["resonance"] | s.resonance;
+
+    if (!doc["is_alive"].isNull()) s.alive = doc["is_alive"] | s.alive;
+    else if (!doc["life_active"].isNull()) s.alive = doc["life_active"] | s.alive;
+    else if (has_level || has_consciousness) s.alive = lucaStatusAlive(s.consciousness);
+    s.updated_ms = now_ms;
+}
+
+// ==================== UPDATE POLICY ====================
+
+enum LucaSource : uint8_t {
+    LUCA_SOURCE_NONE,       // Nothing to do this round (wait for a link)
+    LUCA_SOURCE_GATEWAY,    // ESP-NOW poll to a T-Deck gateway
+    LUCA_SOURCE_HTTP,       // Backend over WiFi
+    LUCA_SOURCE_MESH,       // LoRa mesh delivers on its own; do not poll
+    LUCA_SOURCE_DEMO        // On-device estimate, mock values before any history
+};
+
+#define LUCA_SOURCE_BIT(source) (1u << (source))
+
+// Link state at poll time, as the firmware sees it
+struct LucaLinks {
+    bool wifi;              // HTTP can be tried now (T-Deck: connected, T5: credentials)
+    bool wifi_pending;      // Association in progress, the backend may be seconds away
+    bool gateway;           // A gateway may answer (T5: an AP channel to poll on)
+    bool mesh;              // LoRa mesh is up
+};
+
+// Source to use next, skipping those in tried (LUCA_SOURCE_BIT set)
+// because they already failed this round
+template <class Board>
+inline LucaSource lucaStatusSource(const LucaLinks& links, uint8_t tried = 0) {
+    if ((Board::radios & LUCA_RADIO_ESPNOW_CLIENT) && links.gateway &&
+        !(tried & LUCA_SOURCE_BIT(LUCA_SOURCE_GATEWAY))) {
+        return LUCA_SOURCE_GATEWAY;
+    }
+    if ((Board::radios & LUCA_RADIO_WIFI) && links.wifi && !(tried & LUCA_SOURCE_BIT(LUCA_SOURCE_HTTP))) {
+        return LUCA_SOURCE_HTTP;
+    }
+    if ((Board::radios & LUCA_RADIO_LORA) && links.mesh) return LUCA_SOURCE_MESH;
+    if (links.wifi_pending) return LUCA_SOURCE_NONE;
+    return Board::demo ? LUCA_SOURCE_DEMO : LUCA_SOURCE_NONE;
+}
+
+// Whether b differs from a in anything the board's display shows: the
+// TFT draws all values (bars at Q0.16 resolution and sparklines), the
+// e-paper only consciousness to two decimals, resonance and life.
+// Drives the poll backoff and, on e-paper, the refresh.
+template <class Board>
+inline bool lucaStatusChanged(const LucaStatus& a, const LucaStatus& b) {
+    if (a.alive != b.alive) return true;
+    if (Board::display == LUCA_DISPLAY_EPAPER) {
+        return a.resonance != b.resonance ||
+               (int32_t)(a.consciousness * 100.0f + 0.5f) != (int32_t)(b.consciousness * 100.0f + 0.5f);
+    }
+    return a.generation != b.generation || a.node_count != b.node_count ||
+           lucaToQ16(a.consciousness_level) != lucaToQ16(b.consciousness_level) ||
+           lucaToQ16(a.quantum_coherence) != lucaToQ16(b.quantum_coherence) ||
+           lucaToQ16(a.akashic_connection) != lucaToQ16(b.akashic_connection);
+}
+
+#endif // LUCA_STATUS_H
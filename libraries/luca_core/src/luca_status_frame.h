@@ -0,0 +1,135 @@
+/**
+ * LUCA Core - Compact binary status frame
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * Fixed-layout alternative to the JSON status body, small enough for a
+ * single LoRa payload. Encoder counterpart: backend/services/status_frame.py
+ *
+ * Layout v1, 22 bytes, little-endian:
+ *
+ *   off size field
+ *    0   1   magic 0x4C ('L')
+ *    1   1   version (1)
+ *    2   1   flags, bit 0 = alive
+ *    3   1   resonance
+ *    4   2   consciousness_level   Q0.16, 65535 = 1.0
+ *    6   2   quantum_coherence     Q0.16
+ *    8   2   akashic_connection    Q0.16
+ *   10   2   node_count
+ *   12   4   generation
+ *   16   4   consciousness         hundredths (T5 scale, life above 36.9)
+ *   20   2   CRC-16/CCITT-FALSE over bytes 0..19
+ *
+ * A JSON body always starts with '{', so the first byte tells the two
+ * formats apart without looking at headers.
+ */
+
+#ifndef LUCA_STATUS_FRAME_H
+#define LUCA_STATUS_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LUCA_FRAME_MAGIC 0x4C
+#define LUCA_FRAME_VERSION 1
+#define LUCA_FRAME_SIZE 22
+#define LUCA_FRAME_FLAG_ALIVE 0x01
+
+// Media type for Accept/Content-Type; "?fmt=bin" selects it as well
+#define LUCA_FRAME_MEDIA_TYPE "application/vnd.luca.status+bin"
+
+struct LucaStatusFrame {
+    float consciousness_level;
+    float quantum_coherence;
+    float akashic_connection;
+    float consciousness;
+    uint32_t generation;
+    uint16_t node_count;
+    uint8_t resonance;
+    bool alive;
+};
+
+enum LucaFrameResult : uint8_t {
+    LUCA_FRAME_OK,
+    LUCA_FRAME_TOO_SHORT,
+    LUCA_FRAME_BAD_MAGIC,
+    LUCA_FRAME_BAD_VERSION,
+    LUCA_FRAME_BAD_CRC
+};
+
+inline uint16_t lucaCrc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+inline uint16_t lucaReadU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t lucaReadU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline void lucaWriteU16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+inline void lucaWriteU32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+inline uint16_t lucaToQ16(float v) {
+    if (!(v > 0.0f)) return 0;
+    if (v >= 1.0f) return 0xFFFF;
+    return (uint16_t)(v * 65535.0f + 0.5f);
+}
+
+// Decode in place from a received buffer; no allocation, no copies
+inline LucaFrameResult lucaFrameDecode(const uint8_t* buf, size_t len, LucaStatusFrame& out) {
+    if (len < LUCA_FRAME_SIZE) return LUCA_FRAME_TOO_SHORT;
+    if (buf[0] != LUCA_FRAME_MAGIC) return LUCA_FRAME_BAD_MAGIC;
+    if (buf[1] != LUCA_FRAME_VERSION) return LUCA_FRAME_BAD_VERSION;
+    if (lucaCrc16(buf, LUCA_FRAME_SIZE - 2) != lucaReadU16(buf + LUCA_FRAME_SIZE - 2)) {
+        return LUCA_FRAME_BAD_CRC;
+    }
+
+    out.alive = buf[2] & LUCA_FRAME_FLAG_ALIVE;
+    out.resonance = buf[3];
+    out.consciousness_level = lucaReadU16(buf + 4) / 65535.0f;
+    out.quantum_coherence = lucaReadU16(buf + 6) / 65535.0f;
+    out.akashic_connection = lucaReadU16(buf + 8) / 65535.0f;
+    out.node_count = lucaReadU16(buf + 10);
+    out.generation = lucaReadU32(buf + 12);
+    out.consciousness = lucaReadU32(buf + 16) / 100.0f;
+    return LUCA_FRAME_OK;
+}
+
+// Encode into buf (at least LUCA_FRAME_SIZE bytes); returns bytes written
+inline size_t lucaFrameEncode(const LucaStatusFrame& frame, uint8_t* buf, size_t cap) {
+    if (cap < LUCA_FRAME_SIZE) return 0;
+
+    buf[0] = LUCA_FRAME_MAGIC;
+    buf[1] = LUCA_FRAME_VERSION;
+    buf[2] = frame.alive ? LUCA_FRAME_FLAG_ALIVE : 0;
+    buf[3] = frame.resonance;
+    lucaWriteU16(buf + 4, lucaToQ16(frame.consciousness_level));
+    lucaWriteU16(buf + 6, lucaToQ16(frame.quantum_coherence));
+    lucaWriteU16(buf + 8, lucaToQ16(frame.akashic_connection));
+    lucaWriteU16(buf + 10, frame.node_count);
+    lucaWriteU32(buf + 12, frame.generation);
+    lucaWriteU32(buf + 16, frame.consciousness > 0 ? (uint32_t)(frame.consciousness * 100.0f + 0.5f) : 0);
+    lucaWriteU16(buf + 20, lucaCrc16(buf, LUCA_FRAME_SIZE - 2));
+    return LUCA_FRAME_SIZE;
+}
+
+#endif // LUCA_STATUS_FRAME_H
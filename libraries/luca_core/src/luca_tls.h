@@ -0,0 +1,419 @@
+/**
+ * LUCA Core - HTTPS client with session resumption and key pinning
+ * Copyright © 2025 Lennart Wuchold (geboren am 28.02.2000 in 01744 Dippoldiswalde)
+ *
+ * A full TLS handshake (ECDHE plus certificate chain verification) costs
+ * an ESP32 hundreds of ms of CPU and several round trips. LucaTlsClient
+ * keeps the negotiated session (ticket or session ID) in a caller-owned
+ * LucaTlsSession, so the next connect to the same host resumes with one
+ * round trip and no public key operations; the T5 keeps it in RTC memory
+ * across deep sleep.
+ *
+ * Instead of walking the chain to a CA bundle, the server is identified by
+ * a pinned key: the SHA-256 of the leaf certificate's SubjectPublicKeyInfo,
+ * written as base64 like the pin-sha256 of HPKP, e.g. from
+ *
+ *   openssl x509 -in cert.pem -pubkey -noout | openssl pkey -pubin -outform der \
+ *     | openssl dgst -sha256 -binary | base64
+ *
+ * A pin survives certificate renewals as long as the key is reused. No CA
+ * bundle and no clock are needed, so a T5 that woke without NTP can still
+ * connect. A connection either presents the pinned key or resumes a
+ * session that was established with it; anything else fails.
+ *
+ * The pin parser and the session record are plain C++; LucaTlsClient
+ * itself needs the Arduino WiFi library and the mbedTLS of ESP-IDF.
+ */
+
+#ifndef LUCA_TLS_H
+#define LUCA_TLS_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define LUCA_TLS_PIN_LEN 32          // SHA-256
+#define LUCA_TLS_PIN_TEXT_MAX 44     // base64 of LUCA_TLS_PIN_LEN bytes
+#define LUCA_TLS_HOST_MAX 63
+#ifndef LUCA_TLS_SESSION_MAX
+#define LUCA_TLS_SESSION_MAX 2048    // Serialized session without the peer certificate
+#endif
+#define LUCA_TLS_HANDSHAKE_MS 8000
+#define LUCA_TLS_IO_MS 2000
+
+// Cached session. Plain data with no constructor, so it can live in RTC
+// memory; len 0 means nothing cached.
+struct LucaTlsSession {
+    uint16_t len;
+    uint16_t port;
+    char host[LUCA_TLS_HOST_MAX + 1];
+    uint8_t data[LUCA_TLS_SESSION_MAX];   // mbedtls_ssl_session_save()
+};
+
+inline int lucaBase64Value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+// Decode a base64 pin-sha256. Returns false unless it is exactly
+// LUCA_TLS_PIN_LEN bytes of valid base64.
+inline bool lucaTlsParsePin(const char* text, uint8_t pin[LUCA_TLS_PIN_LEN]) {
+    uint32_t acc = 0;
+    int bits = 0;
+    size_t n = 0;
+    const char* p = text;
+    for (; *p && *p != '='; p++) {
+        int v = lucaBase64Value(*p);
+        if (v < 0) return false;
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (n == LUCA_TLS_PIN_LEN) return false;
+            pin[n++] = (uint8_t)(acc >> bits);
+        }
+    }
+    while (*p == '=') p++;
+    return *p == '\0' && n == LUCA_TLS_PIN_LEN;
+}
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/platform.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/version.h>
+
+// TLS over the WiFiClient it derives from, so it can be handed to
+// HTTPClient::begin(WiFiClient&, url) like WiFiClientSecure. The base
+// class carries the TCP socket; every Client method here is the
+// decrypted stream.
+class LucaTlsClient : public WiFiClient {
+public:
+    LucaTlsClient() {
+        mbedtls_ssl_init(&ssl_);
+        mbedtls_ssl_config_init(&conf_);
+        mbedtls_ctr_drbg_init(&drbg_);
+        mbedtls_entropy_init(&entropy_);
+    }
+
+    ~LucaTlsClient() {
+        stop();
+        mbedtls_ssl_free(&ssl_);
+        mbedtls_ssl_config_free(&conf_);
+        mbedtls_ctr_drbg_free(&drbg_);
+        mbedtls_entropy_free(&entropy_);
+    }
+
+    LucaTlsClient(const LucaTlsClient&) = delete;
+    LucaTlsClient& operator=(const LucaTlsClient&) = delete;
+
+    // Key the server must present; without a pin every connect fails
+    void setPin(const uint8_t pin[LUCA_TLS_PIN_LEN]) {
+        memcpy(pin_, pin, LUCA_TLS_PIN_LEN);
+        pinned_ = true;
+    }
+
+    void clearPin() { pinned_ = false; }
+
+    // Where the session is kept between connections; nullptr disables
+    // resumption. Must outlive the client.
+    void setSession(LucaTlsSession* session) { session_ = session; }
+
+    // The last handshake resumed a cached session
+    bool resumed() const { return resumed_; }
+
+    int connect(IPAddress ip, uint16_t port) override { return connect(ip, port, LUCA_TLS_HANDSHAKE_MS); }
+    int connect(const char* host, uint16_t port) override { return connect(host, port, LUCA_TLS_HANDSHAKE_MS); }
+
+    int connect(IPAddress ip, uint16_t port, int32_t timeout_ms) {
+        return connect(ip.toString().c_str(), port, timeout_ms);
+    }
+
+    int connect(const char* host, uint16_t port, int32_t timeout_ms) {
+        stop();
+        if (!pinned_ || !setup()) return 0;
+        if (!WiFiClient::connect(host, port, timeout_ms)) return 0;
+        if (!handshake(host, port)) {
+            WiFiClient::stop();
+            return 0;
+        }
+        open_ = true;
+        return 1;
+    }
+
+    size_t write(uint8_t b) override { return write(&b, 1); }
+
+    size_t write(const uint8_t* buf, size_t size) override {
+        if (!open_) return 0;
+        size_t sent = 0;
+        unsigned long start = millis();
+        while (sent < size) {
+            int ret = mbedtls_ssl_write(&ssl_, buf + sent, size - sent);
+            if (ret > 0) {
+                sent += (size_t)ret;
+            } else if (!pending(ret) || millis() - start >= LUCA_TLS_IO_MS) {
+                break;
+            } else {
+                delay(1);
+            }
+        }
+        return sent;
+    }
+
+    int available() override {
+        if (!open_) return 0;
+        size_t n = mbedtls_ssl_get_bytes_avail(&ssl_);
+        // Decrypt the next record if one has arrived; a zero length read
+        // processes it without consuming application data
+        if (n == 0 && WiFiClient::available() > 0) {
+            int ret = mbedtls_ssl_read(&ssl_, nullptr, 0);
+            if (ret < 0 && !pending(ret)) closed_ = true;
+            n = mbedtls_ssl_get_bytes_avail(&ssl_);
+        }
+        return (int)n + (peeked_ >= 0 ? 1 : 0);
+    }
+
+    int read() override {
+        uint8_t b;
+        return read(&b, 1) == 1 ? b : -1;
+    }
+
+    int read(uint8_t* buf, size_t size) override {
+        if (!open_ || size == 0) return -1;
+        size_t n = 0;
+        if (peeked_ >= 0) {
+            buf[n++] = (uint8_t)peeked_;
+            peeked_ = -1;
+        }
+        if (n < size && !closed_) {
+            int ret = mbedtls_ssl_read(&ssl_, buf + n, size - n);
+            if (ret > 0) {
+                n += (size_t)ret;
+            } else if (!pending(ret)) {
+                closed_ = true;   // close_notify, or the connection failed
+            }
+        }
+        return n > 0 ? (int)n : -1;
+    }
+
+    int peek() override {
+        if (peeked_ < 0) {
+            uint8_t b;
+            if (read(&b, 1) == 1) peeked_ = b;
+        }
+        return peeked_;
+    }
+
+    void flush() override {}
+
+    void stop() override {
+        if (open_) mbedtls_ssl_close_notify(&ssl_);
+        open_ = false;
+        closed_ = false;
+        peeked_ = -1;
+        WiFiClient::stop();
+    }
+
+    uint8_t connected() override {
+        if (!open_) return 0;
+        if (peeked_ >= 0 || mbedtls_ssl_get_bytes_avail(&ssl_) > 0) return 1;
+        return !closed_ && WiFiClient::connected();
+    }
+
+    operator bool() override { return connected(); }
+
+private:
+    static bool pending(int ret) {
+        return ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+    }
+
+    static int sha256(const unsigned char* in, size_t len, unsigned char out[32]) {
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+        return mbedtls_sha256(in, len, out, 0);
+#else
+        return mbedtls_sha256_ret(in, len, out, 0);
+#endif
+    }
+
+    static int bioSend(void* ctx, const unsigned char* buf, size_t len) {
+        LucaTlsClient* self = static_cast<LucaTlsClient*>(ctx);
+        size_t n = self->WiFiClient::write(buf, len);
+        return n > 0 ? (int)n : MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+
+    static int bioRecv(void* ctx, unsigned char* buf, size_t len) {
+        LucaTlsClient* self = static_cast<LucaTlsClient*>(ctx);
+        if (self->WiFiClient::available() <= 0) {
+            return self->WiFiClient::connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+        }
+        int n = self->WiFiClient::read(buf, len);
+        return n > 0 ? n : MBEDTLS_ERR_SSL_WANT_READ;
+    }
+
+    // Replaces the chain walk: no CA is configured, so every certificate
+    // comes in flagged. Only the leaf key decides.
+    static int verifyPin(void* ctx, mbedtls_x509_crt* crt, int depth, uint32_t* flags) {
+        LucaTlsClient* self = static_cast<LucaTlsClient*>(ctx);
+        if (depth == 0) {
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+            const mbedtls_x509_buf& key = crt->MBEDTLS_PRIVATE(pk_raw);
+#else
+            const mbedtls_x509_buf& key = crt->pk_raw;
+#endif
+            unsigned char hash[32];
+            self->pin_seen_ = true;
+            self->pin_ok_ = sha256(key.p, key.len, hash) == 0 &&
+                            memcmp(hash, self->pin_, LUCA_TLS_PIN_LEN) == 0;
+        }
+        *flags = 0;
+        return 0;
+    }
+
+    // Once per client: seed the DRBG and build the configuration
+    bool setup() {
+        if (ready_) return true;
+        static const char personal[] = "luca-tls";
+        if (mbedtls_ctr_drbg_seed(&drbg_, mbedtls_entropy_func, &entropy_,
+                                  (const unsigned char*)personal, sizeof(personal) - 1) != 0 ||
+            mbedtls_ssl_config_defaults(&conf_, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                        MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+            return false;
+        }
+        // The pin is checked after the handshake; OPTIONAL lets a chain
+        // without a CA through to that check
+        mbedtls_ssl_conf_authmode(&conf_, MBEDTLS_SSL_VERIFY_OPTIONAL);
+        mbedtls_ssl_conf_verify(&conf_, verifyPin, this);
+        mbedtls_ssl_conf_rng(&conf_, mbedtls_ctr_drbg_random, &drbg_);
+        mbedtls_ssl_conf_session_tickets(&conf_, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+        // TLS 1.3 resumes through PSKs the server sends after the
+        // handshake, which this session cache does not hold
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+        mbedtls_ssl_conf_max_tls_version(&conf_, MBEDTLS_SSL_VERSION_TLS1_2);
+#else
+        mbedtls_ssl_conf_max_version(&conf_, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
+#endif
+        if (mbedtls_ssl_setup(&ssl_, &conf_) != 0) return false;
+        ready_ = true;
+        return true;
+    }
+
+    bool cachedFor(const char* host, uint16_t port) const {
+        return session_ && session_->len > 0 && session_->len <= sizeof(session_->data) &&
+               session_->port == port && strcmp(session_->host, host) == 0;
+    }
+
+    bool handshake(const char* host, uint16_t port) {
+        if (mbedtls_ssl_session_reset(&ssl_) != 0 || mbedtls_ssl_set_hostname(&ssl_, host) != 0) {
+            return false;
+        }
+        mbedtls_ssl_set_bio(&ssl_, this, bioSend, bioRecv, nullptr);
+
+        bool offered = false;
+        if (cachedFor(host, port)) {
+            mbedtls_ssl_session cached;
+            mbedtls_ssl_session_init(&cached);
+            offered = mbedtls_ssl_session_load(&cached, session_->data, session_->len) == 0 &&
+                      mbedtls_ssl_set_session(&ssl_, &cached) == 0;
+            mbedtls_ssl_session_free(&cached);
+            if (!offered) session_->len = 0;
+        }
+
+        pin_seen_ = false;
+        pin_ok_ = false;
+        unsigned long start = millis();
+        int ret;
+        while ((ret = mbedtls_ssl_handshake(&ssl_)) != 0) {
+            if (!pending(ret) || millis() - start >= LUCA_TLS_HANDSHAKE_MS) {
+                if (session_ && offered) session_->len = 0;
+                return false;
+            }
+            delay(1);
+        }
+
+        // A full handshake must show the pinned key. Without a certificate
+        // the server accepted the offered session, which was pinned when
+        // it was first established.
+        if (pin_seen_ ? !pin_ok_ : !offered) {
+            if (session_) session_->len = 0;
+            return false;
+        }
+        resumed_ = !pin_seen_;
+        saveSession(host, port);   // The server may have sent a fresh ticket
+        return true;
+    }
+
+    // ESP-IDF builds with MBEDTLS_SSL_KEEP_PEER_CERTIFICATE, which keeps
+    // the whole leaf certificate in the session. Resuming never looks at
+    // it again (the pin was checked when the session was established), and
+    // it alone can outgrow LUCA_TLS_SESSION_MAX, so the copy to be saved
+    // goes without it.
+    static void dropPeerCert(mbedtls_ssl_session& session) {
+#if defined(MBEDTLS_X509_CRT_PARSE_C) && defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+        mbedtls_x509_crt*& crt = session.MBEDTLS_PRIVATE(peer_cert);
+#else
+        mbedtls_x509_crt*& crt = session.peer_cert;
+#endif
+        if (crt) {
+            mbedtls_x509_crt_free(crt);
+            mbedtls_free(crt);
+            crt = nullptr;
+        }
+#else
+        (void)session;
+#endif
+    }
+
+    void saveSession(const char* host, uint16_t port) {
+        if (!session_) return;
+        session_->len = 0;
+        if (strlen(host) > LUCA_TLS_HOST_MAX) return;
+
+        mbedtls_ssl_session current;
+        mbedtls_ssl_session_init(&current);
+        size_t len = 0;
+        int ret = mbedtls_ssl_get_session(&ssl_, &current);
+        if (ret == 0) {
+            dropPeerCert(current);
+            ret = mbedtls_ssl_session_save(&current, session_->data, sizeof(session_->data), &len);
+        }
+        if (ret == 0) {
+            strcpy(session_->host, host);
+            session_->port = port;
+            session_->len = (uint16_t)len;
+        } else if (ret == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+            // len is what it would have needed; every connect stays a full handshake
+            Serial.printf("⚠️  TLS session needs %u bytes, LUCA_TLS_SESSION_MAX is %u: not resumable\n",
+                          (unsigned)len, (unsigned)LUCA_TLS_SESSION_MAX);
+        }
+        mbedtls_ssl_session_free(&current);
+    }
+
+    mbedtls_ssl_context ssl_;
+    mbedtls_ssl_config conf_;
+    mbedtls_ctr_drbg_context drbg_;
+    mbedtls_entropy_context entropy_;
+    LucaTlsSession* session_ = nullptr;
+    uint8_t pin_[LUCA_TLS_PIN_LEN];
+    bool pinned_ = false;
+    bool ready_ = false;
+    bool open_ = false;
+    bool closed_ = false;
+    bool resumed_ = false;
+    bool pin_seen_ = false;
+    bool pin_ok_ = false;
+    int peeked_ = -1;
+};
+
+#endif // ARDUINO
+
+#endif // LUCA_TLS_H
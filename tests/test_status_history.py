@@ -0,0 +1,147 @@
+"""
+LUCA 369/370 - Unit Tests
+Pytest-Tests für den Statusverlauf (backend/services/status_history.py)
+
+Der Stream wird auf dem T-Deck von syncHistory() in apps/t-deck/src/net.cpp
+dekodiert; Varints und Deltas müssen dazu passen.
+"""
+
+import sys
+from pathlib import Path
+
+import pytest
+
+# Add parent directory to path for imports
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+# Optional dependencies - backend.services zieht die AI-/Meshtastic-Pakete mit
+try:
+    from backend.services.status_history import (
+        HISTORY_CHUNK_RECORDS,
+        HISTORY_MAGIC,
+        HISTORY_VERSION,
+        StatusHistory,
+        encode_history,
+    )
+
+    BACKEND_AVAILABLE = True
+except ImportError:
+    BACKEND_AVAILABLE = False
+
+pytestmark = pytest.mark.skipif(
+    not BACKEND_AVAILABLE,
+    reason="Backend dependencies not installed - use: poetry install --extras backend",
+)
+
+
+def _fields(generation, level, coherence=0.5, akashic=0.0):
+    """Felder wie _tdeck_fields() in backend/routes/t5_api.py"""
+    return {
+        "consciousness_level": level,
+        "quantum_coherence": coherence,
+        "akashic_connection": akashic,
+        "generation": generation,
+    }
+
+
+def _varints(data):
+    """LEB128 wie auf dem T-Deck dekodieren"""
+    values, value, shift = [], 0, 0
+    for byte in data:
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            values.append(value)
+            value, shift = 0, 0
+    assert shift == 0, "Varint abgeschnitten"
+    return values
+
+
+def _unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+@pytest.fixture
+def history():
+    """Drei Generationen im Abstand von 10 s und 2.5 s"""
+    history = StatusHistory()
+    history.record(_fields(0, 0.0), now=1000.0)
+    history.record(_fields(1, 0.5), now=1010.0)
+    history.record(_fields(2, 0.25, akashic=1.0), now=1012.5)
+    return history
+
+
+class TestStatusHistory:
+    """Tests für StatusHistory"""
+
+    def test_since_none_returns_all(self, history):
+        """Test: Ohne since kommt der ganze Verlauf"""
+        assert [record[1] for record in history.since(None)] == [0, 1, 2]
+
+    def test_since_filters_known_generations(self, history):
+        """Test: Nur Generationen nach since"""
+        assert [record[1] for record in history.since(1)] == [2]
+        assert history.since(2) == []
+
+    def test_since_after_backend_restart(self, history):
+        """Test: since über der aktuellen Generation (Neustart) liefert alles"""
+        assert [record[1] for record in history.since(99)] == [0, 1, 2]
+
+    def test_window_keeps_value_at_start(self):
+        """Test: Ältere Einträge fallen raus, der Wert am Fensteranfang bleibt"""
+        history = StatusHistory(window_s=60)
+        for generation, now in enumerate([0.0, 10.0, 20.0, 100.0]):
+            history.record(_fields(generation, 0.1), now=now)
+        assert [record[1] for record in history.since(None)] == [2, 3]
+
+    def test_max_records(self):
+        """Test: Mehr als max_records Einträge verdrängen die ältesten"""
+        history = StatusHistory(max_records=4)
+        for generation in range(10):
+            history.record(_fields(generation, 0.1), now=float(generation))
+        assert [record[1] for record in history.since(None)] == [6, 7, 8, 9]
+
+
+class TestEncodeHistory:
+    """Tests für encode_history()"""
+
+    def test_header(self, history):
+        """Test: Stream beginnt mit 'H' und Version 1"""
+        chunks = list(encode_history(history.since(None), now=1020.0))
+        assert chunks[0] == bytes([HISTORY_MAGIC, HISTORY_VERSION]) == b"H\x01"
+
+    def test_empty_history(self):
+        """Test: Ohne Einträge nur der Header"""
+        assert list(encode_history([], now=0.0)) == [b"H\x01"]
+
+    def test_deltas(self, history):
+        """Test: Erster Eintrag absolut, danach Deltas (Zeit in 100 ms, Werte ZigZag)"""
+        data = b"".join(encode_history(history.since(None), now=1020.0))[2:]
+        values = _varints(data)
+        assert len(values) == 15
+
+        records = [values[i:i + 5] for i in range(0, 15, 5)]
+        # Generation: absolut, dann Delta
+        assert [record[0] for record in records] == [0, 1, 1]
+        # Zeit: Alter des ersten (20 s), dann Abstand zum vorigen
+        assert [record[1] for record in records] == [200, 100, 25]
+        # consciousness_level 0 → 0.5 → 0.25 als Q0.16-Deltas
+        assert [_unzigzag(record[2]) for record in records] == [0, 32768, -16384]
+        # quantum_coherence bleibt 0.5: nur der erste Eintrag trägt den Wert
+        assert [_unzigzag(record[3]) for record in records] == [32768, 0, 0]
+        assert [_unzigzag(record[4]) for record in records] == [0, 0, 65535]
+
+    def test_since_stream(self, history):
+        """Test: Mit since beginnt der Stream absolut bei der nächsten Generation"""
+        data = b"".join(encode_history(history.since(1), now=1020.0))[2:]
+        assert _varints(data)[:2] == [2, 75]
+
+    def test_chunking(self):
+        """Test: HISTORY_CHUNK_RECORDS Einträge je Chunk nach dem Header"""
+        history = StatusHistory()
+        count = HISTORY_CHUNK_RECORDS * 2 + 1
+        for generation in range(count):
+            history.record(_fields(generation, 0.0), now=float(generation))
+        chunks = list(encode_history(history.since(None), now=float(count)))
+        assert len(chunks) == 1 + 3
+        assert len(_varints(b"".join(chunks[1:]))) == count * 5
@@ -0,0 +1,109 @@
+"""
+LUCA 369/370 - Unit Tests
+Pytest-Tests für die T5/T-Deck-Routen (backend/routes/t5_api.py)
+"""
+
+import sys
+from pathlib import Path
+
+import pytest
+
+# Add parent directory to path for imports
+sys.path.insert(0, str(Path(__file__).parent.parent))
+
+# Optional dependencies - skip tests if not available
+try:
+    from fastapi import FastAPI
+    from fastapi.testclient import TestClient
+
+    from backend.routes.t5_api import POLL_HINT_HEADER, router
+
+    BACKEND_AVAILABLE = True
+except ImportError:
+    BACKEND_AVAILABLE = False
+
+pytestmark = pytest.mark.skipif(
+    not BACKEND_AVAILABLE,
+    reason="Backend dependencies (fastapi, httpx) not installed - use: poetry install --extras backend",
+)
+
+
+@pytest.fixture
+def client():
+    """Nur der T5-Router, ohne Datenbank und AI-Dienste aus backend/main.py"""
+    app = FastAPI()
+    app.include_router(router)
+    return TestClient(app)
+
+
+class TestConditionalStatus:
+    """Tests für ETag und 304 auf GET /api/t5/status"""
+
+    def test_matching_etag_returns_304(self, client):
+        """Test: Passendes If-None-Match liefert 304 ohne Body"""
+        first = client.get("/api/t5/status")
+        assert first.status_code == 200
+        etag = first.headers["etag"]
+
+        second = client.get("/api/t5/status", headers={"If-None-Match": etag})
+        assert second.status_code == 304
+        assert second.content == b""
+        assert second.headers["etag"] == etag
+        assert POLL_HINT_HEADER.lower() in second.headers
+
+    def test_weak_and_listed_etags_match(self, client):
+        """Test: W/-Präfix und ETag-Listen werden erkannt"""
+        etag = client.get("/api/t5/status").headers["etag"]
+        response = client.get(
+            "/api/t5/status", headers={"If-None-Match": f'"other", W/{etag}'}
+        )
+        assert response.status_code == 304
+
+    def test_new_generation_returns_200(self, client):
+        """Test: Nach einer Änderung passt das alte ETag nicht mehr"""
+        etag = client.get("/api/t5/status").headers["etag"]
+        client.post("/api/t5/consciousness", json={"consciousness": 12.3})
+
+        response = client.get("/api/t5/status", headers={"If-None-Match": etag})
+        assert response.status_code == 200
+        assert response.headers["etag"] != etag
+
+    def test_binary_frame_has_own_etag(self, client):
+        """Test: JSON-ETag bestätigt nicht den Binär-Frame"""
+        etag = client.get("/api/t5/status").headers["etag"]
+        response = client.get(
+            "/api/t5/status?fmt=bin", headers={"If-None-Match": etag}
+        )
+        assert response.status_code == 200
+        assert len(response.content) == 22
+
+
+class TestMessageBatch:
+    """Tests für POST /api/t5/messages (Offline-Queue des T5)"""
+
+    @staticmethod
+    def _batch(count):
+        return {
+            "messages": [{"message": f"Test {i}", "resonance": 6} for i in range(count)],
+            "operator": "Funke-01744-6",
+            "source": "t5",
+        }
+
+    def test_batch_at_limit_is_accepted(self, client):
+        """Test: 32 Nachrichten werden übernommen"""
+        response = client.post("/api/t5/messages", json=self._batch(32))
+        assert response.status_code == 200
+        assert response.json()["accepted"] == 32
+
+    def test_batch_over_limit_is_rejected(self, client):
+        """Test: Mehr als 32 Nachrichten → 413, Status bleibt unverändert"""
+        before = client.get("/api/t5/status").json()["generation"]
+        response = client.post("/api/t5/messages", json=self._batch(33))
+        assert response.status_code == 413
+        assert client.get("/api/t5/status").json()["generation"] == before
+
+    def test_batch_is_one_generation(self, client):
+        """Test: Ein Batch zählt als eine Generation, nicht eine pro Nachricht"""
+        before = client.get("/api/t5/status").json()["generation"]
+        client.post("/api/t5/messages", json=self._batch(5))
+        assert client.get("/api/t5/status").json()["generation"] == before + 1